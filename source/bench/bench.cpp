@@ -0,0 +1,515 @@
+/** bench.cpp
+ * Copyright © 2021 Gene Harvey
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license. See the LICENSE file for details.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+// Microbenchmarks for the common tracker operations. Each operation is timed
+// on freshly built bindings for every size and repetition, and the results are
+// written as JSON so that runs may be compared against each other.
+//
+// usage: tracker.bench [--seed N] [--repetitions N] [--sizes N,N,...] [--out FILE]
+
+#include "gch/tracker/reporter.hpp"
+#include "gch/tracker/tracker.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace gch;
+
+namespace
+{
+
+  //////////////
+  // fixtures //
+  //////////////
+
+  // Each fixture binds many leaves to a hub. The leaves are either reporters
+  // or trackers, and are either derived from (intrusive) or members of
+  // (nonintrusive) the objects being bound.
+
+  struct ihub_r;
+
+  struct ileaf_r
+    : reporter<ileaf_r, remote::intrusive_tracker<ihub_r>, tag::intrusive>
+  {
+    using base = reporter<ileaf_r, remote::intrusive_tracker<ihub_r>, tag::intrusive>;
+
+    ileaf_r (tag::bind_t, base::remote_interface_type& hub)
+      : base (tag::bind, hub)
+    { }
+  };
+
+  struct ihub_r
+    : tracker<ihub_r, remote::intrusive_reporter<ileaf_r>, tag::intrusive>
+  {
+    using tracker_type = tracker<ihub_r, remote::intrusive_reporter<ileaf_r>, tag::intrusive>;
+
+    tracker_type&
+    get_tracker (void) noexcept
+    {
+      return *this;
+    }
+
+    static
+    void
+    debind (ileaf_r& leaf, ihub_r&) noexcept
+    {
+      leaf.debind ();
+    }
+  };
+
+  struct nhub_r;
+
+  struct nleaf_r
+  {
+    using reporter_type = reporter<nleaf_r, remote::tracker<nhub_r>>;
+
+    nleaf_r (tag::bind_t, nhub_r& hub);
+
+    nleaf_r (nleaf_r&& other) noexcept
+      : m_reporter (std::move (other.m_reporter), *this)
+    { }
+
+    reporter_type m_reporter;
+  };
+
+  struct nhub_r
+  {
+    using tracker_type = tracker<nhub_r, remote::reporter<nleaf_r>>;
+
+    nhub_r (void)
+      : m_tracker (*this)
+    { }
+
+    tracker_type&
+    get_tracker (void) noexcept
+    {
+      return m_tracker;
+    }
+
+    static
+    void
+    debind (nleaf_r& leaf, nhub_r&) noexcept
+    {
+      leaf.m_reporter.debind ();
+    }
+
+    tracker_type m_tracker;
+  };
+
+  nleaf_r::nleaf_r (tag::bind_t, nhub_r& hub)
+    : m_reporter (*this, hub.m_tracker)
+  { }
+
+  struct inode_t
+    : tracker<inode_t, remote::intrusive_tracker<inode_t>, tag::intrusive>
+  {
+    using tracker_type = tracker<inode_t, remote::intrusive_tracker<inode_t>, tag::intrusive>;
+
+    inode_t (void) = default;
+
+    inode_t (tag::bind_t, inode_t& hub)
+    {
+      this->bind (hub);
+    }
+
+    inode_t (inode_t&&) noexcept = default;
+
+    tracker_type&
+    get_tracker (void) noexcept
+    {
+      return *this;
+    }
+
+    static
+    void
+    debind (inode_t& leaf, inode_t& hub)
+    {
+      leaf.tracker_type::debind (hub);
+    }
+  };
+
+  struct nnode_t
+  {
+    using tracker_type = tracker<nnode_t, remote::tracker<nnode_t>>;
+
+    nnode_t (void)
+      : m_tracker (*this)
+    { }
+
+    nnode_t (tag::bind_t, nnode_t& hub)
+      : m_tracker (*this)
+    {
+      m_tracker.bind (hub.m_tracker);
+    }
+
+    nnode_t (nnode_t&& other) noexcept
+      : m_tracker (std::move (other.m_tracker), *this)
+    { }
+
+    tracker_type&
+    get_tracker (void) noexcept
+    {
+      return m_tracker;
+    }
+
+    static
+    void
+    debind (nnode_t& leaf, nnode_t& hub)
+    {
+      leaf.m_tracker.debind (hub.m_tracker);
+    }
+
+    tracker_type m_tracker;
+  };
+
+  template <typename Hub, typename Leaf>
+  struct fixture
+  {
+    using hub_type  = Hub;
+    using leaf_type = Leaf;
+
+    const char *name;
+  };
+
+  ///////////////
+  // harnesses //
+  ///////////////
+
+  using clock_type = std::chrono::steady_clock;
+
+  struct options
+  {
+    std::uint32_t            seed        = 20210501;
+    std::size_t              repetitions = 15;
+    std::vector<std::size_t> sizes       { 16, 256, 4096 };
+    std::string              out;
+  };
+
+  struct result
+  {
+    std::string fixture;
+    std::string operation;
+    std::size_t size;
+    double      min_ns;
+    double      median_ns;
+    double      mean_ns;
+  };
+
+  // keeps the optimizer from discarding the work being measured
+  std::uintptr_t sink = 0;
+
+  template <typename Fixture>
+  class runner
+  {
+    using hub_type  = typename Fixture::hub_type;
+    using leaf_type = typename Fixture::leaf_type;
+
+  public:
+    runner (const Fixture& f, const options& opts, std::vector<result>& results)
+      : m_fixture (f),
+        m_options (opts),
+        m_results (results),
+        m_gen     (opts.seed)
+    { }
+
+    void
+    run (void)
+    {
+      for (const std::size_t n : m_options.sizes)
+      {
+        measure ("bind",        n, &runner::bind);
+        measure ("debind",      n, &runner::debind);
+        measure ("splice",      n, &runner::splice);
+        measure ("transfer",    n, &runner::transfer);
+        measure ("iteration",   n, &runner::iteration);
+        measure ("relocation",  n, &runner::relocation);
+        measure ("destruction", n, &runner::destruction);
+      }
+    }
+
+  private:
+    using operation = clock_type::duration (runner::*) (std::size_t);
+
+    void
+    measure (const char *name, std::size_t n, operation op)
+    {
+      std::vector<double> samples;
+      samples.reserve (m_options.repetitions);
+      for (std::size_t i = 0; i < m_options.repetitions; ++i)
+      {
+        using ns = std::chrono::duration<double, std::nano>;
+        samples.push_back (std::chrono::duration_cast<ns> ((this->*op) (n)).count ());
+      }
+
+      std::sort (samples.begin (), samples.end ());
+      const double sum = std::accumulate (samples.begin (), samples.end (), 0.0);
+      m_results.push_back ({ m_fixture.name, name, n,
+                             samples.front (),
+                             samples[samples.size () / 2],
+                             sum / static_cast<double> (samples.size ()) });
+    }
+
+    static
+    std::vector<leaf_type>
+    make_leaves (hub_type& hub, std::size_t n)
+    {
+      std::vector<leaf_type> leaves;
+      leaves.reserve (n);
+      for (std::size_t i = 0; i < n; ++i)
+        leaves.emplace_back (tag::bind, hub);
+      return leaves;
+    }
+
+    clock_type::duration
+    bind (std::size_t n)
+    {
+      hub_type hub;
+      std::vector<leaf_type> leaves;
+      leaves.reserve (n);
+
+      const auto t1 = clock_type::now ();
+      for (std::size_t i = 0; i < n; ++i)
+        leaves.emplace_back (tag::bind, hub);
+      const auto t2 = clock_type::now ();
+
+      return t2 - t1;
+    }
+
+    // debinds in a seeded random order, so that erasures land all over the list
+    clock_type::duration
+    debind (std::size_t n)
+    {
+      hub_type hub;
+      std::vector<leaf_type> leaves = make_leaves (hub, n);
+
+      std::vector<std::size_t> order (n);
+      std::iota (order.begin (), order.end (), std::size_t { 0 });
+      std::shuffle (order.begin (), order.end (), m_gen);
+
+      const auto t1 = clock_type::now ();
+      for (const std::size_t i : order)
+        hub_type::debind (leaves[i], hub);
+      const auto t2 = clock_type::now ();
+
+      return t2 - t1;
+    }
+
+    clock_type::duration
+    splice (std::size_t n)
+    {
+      hub_type dst;
+      hub_type src;
+      std::vector<leaf_type> dst_leaves = make_leaves (dst, n);
+      std::vector<leaf_type> src_leaves = make_leaves (src, n);
+
+      const auto t1 = clock_type::now ();
+      dst.get_tracker ().splice_back (src.get_tracker ());
+      const auto t2 = clock_type::now ();
+
+      return t2 - t1;
+    }
+
+    // moves the back half of the bindings of one hub into the middle of another
+    clock_type::duration
+    transfer (std::size_t n)
+    {
+      hub_type dst;
+      hub_type src;
+      std::vector<leaf_type> dst_leaves = make_leaves (dst, n);
+      std::vector<leaf_type> src_leaves = make_leaves (src, n);
+
+      auto& dst_tracker = dst.get_tracker ();
+      auto& src_tracker = src.get_tracker ();
+      const auto pos   = std::next (dst_tracker.cbegin (), static_cast<std::ptrdiff_t> (n / 2));
+      const auto first = std::next (src_tracker.cbegin (), static_cast<std::ptrdiff_t> (n / 2));
+
+      const auto t1 = clock_type::now ();
+      dst_tracker.transfer (pos, src_tracker, first, src_tracker.cend ());
+      const auto t2 = clock_type::now ();
+
+      return t2 - t1;
+    }
+
+    clock_type::duration
+    iteration (std::size_t n)
+    {
+      hub_type hub;
+      std::vector<leaf_type> leaves = make_leaves (hub, n);
+
+      std::uintptr_t acc = 0;
+      const auto t1 = clock_type::now ();
+      for (const auto& remote : hub.get_tracker ())
+        acc += reinterpret_cast<std::uintptr_t> (&remote);
+      const auto t2 = clock_type::now ();
+
+      sink = acc;
+      return t2 - t1;
+    }
+
+    // moves every leaf into new storage, as a vector does when it grows
+    clock_type::duration
+    relocation (std::size_t n)
+    {
+      hub_type hub;
+      std::vector<leaf_type> leaves = make_leaves (hub, n);
+      std::vector<leaf_type> moved;
+      moved.reserve (n);
+
+      const auto t1 = clock_type::now ();
+      for (leaf_type& leaf : leaves)
+        moved.emplace_back (std::move (leaf));
+      const auto t2 = clock_type::now ();
+
+      return t2 - t1;
+    }
+
+    clock_type::duration
+    destruction (std::size_t n)
+    {
+      hub_type hub;
+      std::vector<leaf_type> leaves = make_leaves (hub, n);
+
+      const auto t1 = clock_type::now ();
+      leaves.clear ();
+      const auto t2 = clock_type::now ();
+
+      return t2 - t1;
+    }
+
+    const Fixture&        m_fixture;
+    const options&        m_options;
+    std::vector<result>&  m_results;
+    std::mt19937          m_gen;
+  };
+
+  template <typename Fixture>
+  void
+  run_fixture (const Fixture& f, const options& opts, std::vector<result>& results)
+  {
+    runner<Fixture> (f, opts, results).run ();
+  }
+
+  ////////////
+  // output //
+  ////////////
+
+  void
+  write_json (std::ostream& os, const options& opts, const std::vector<result>& results)
+  {
+    os << "{\n"
+       << "  \"seed\": " << opts.seed << ",\n"
+       << "  \"repetitions\": " << opts.repetitions << ",\n"
+       << "  \"unit\": \"ns\",\n"
+       << "  \"results\": [\n";
+
+    for (std::size_t i = 0; i < results.size (); ++i)
+    {
+      const result& r = results[i];
+      os << "    { \"fixture\": \"" << r.fixture << "\""
+         << ", \"operation\": \"" << r.operation << "\""
+         << ", \"size\": " << r.size
+         << ", \"min\": " << r.min_ns
+         << ", \"median\": " << r.median_ns
+         << ", \"mean\": " << r.mean_ns
+         << ", \"median_per_element\": " << r.median_ns / static_cast<double> (r.size)
+         << " }" << (i + 1 < results.size () ? ",\n" : "\n");
+    }
+
+    os << "  ]\n"
+       << "}\n";
+  }
+
+  bool
+  parse_sizes (const char *arg, std::vector<std::size_t>& sizes)
+  {
+    sizes.clear ();
+    std::string s (arg);
+    std::size_t pos = 0;
+    while (pos <= s.size ())
+    {
+      const std::size_t comma = std::min (s.find (',', pos), s.size ());
+      const unsigned long long n = std::strtoull (s.substr (pos, comma - pos).c_str (), nullptr,
+                                                  10);
+      if (n == 0)
+        return false;
+      sizes.push_back (static_cast<std::size_t> (n));
+      pos = comma + 1;
+    }
+    return true;
+  }
+
+  bool
+  parse_options (int argc, char **argv, options& opts)
+  {
+    for (int i = 1; i < argc; ++i)
+    {
+      if (i + 1 == argc)
+        return false;
+
+      const char *value = argv[i + 1];
+      if (std::strcmp (argv[i], "--seed") == 0)
+        opts.seed = static_cast<std::uint32_t> (std::strtoul (value, nullptr, 10));
+      else if (std::strcmp (argv[i], "--repetitions") == 0)
+        opts.repetitions = static_cast<std::size_t> (std::strtoull (value, nullptr, 10));
+      else if (std::strcmp (argv[i], "--sizes") == 0)
+      {
+        if (! parse_sizes (value, opts.sizes))
+          return false;
+      }
+      else if (std::strcmp (argv[i], "--out") == 0)
+        opts.out = value;
+      else
+        return false;
+      ++i;
+    }
+    return opts.repetitions != 0;
+  }
+
+}
+
+int
+main (int argc, char **argv)
+{
+  options opts;
+  if (! parse_options (argc, argv, opts))
+  {
+    std::cerr << "usage: " << argv[0]
+              << " [--seed N] [--repetitions N] [--sizes N,N,...] [--out FILE]" << std::endl;
+    return 2;
+  }
+
+  std::vector<result> results;
+  run_fixture (fixture<ihub_r,  ileaf_r> { "intrusive_reporter"    }, opts, results);
+  run_fixture (fixture<nhub_r,  nleaf_r> { "nonintrusive_reporter" }, opts, results);
+  run_fixture (fixture<inode_t, inode_t> { "intrusive_tracker"     }, opts, results);
+  run_fixture (fixture<nnode_t, nnode_t> { "nonintrusive_tracker"  }, opts, results);
+
+  if (opts.out.empty ())
+    write_json (std::cout, opts, results);
+  else
+  {
+    std::ofstream ofs (opts.out);
+    if (! ofs)
+    {
+      std::cerr << "could not open " << opts.out << std::endl;
+      return 1;
+    }
+    write_json (ofs, opts, results);
+  }
+
+  return 0;
+}
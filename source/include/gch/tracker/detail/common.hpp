@@ -93,10 +93,26 @@
 #  endif
 #endif
 
+#if defined (__cplusplus) && __cplusplus >= 201703L
+#  if defined (__has_include) && __has_include (<memory_resource>)
+#    include <memory_resource>
+#  endif
+#endif
+
+#if defined (__cpp_lib_memory_resource) && __cpp_lib_memory_resource >= 201603L
+#  ifndef GCH_LIB_MEMORY_RESOURCE
+#    define GCH_LIB_MEMORY_RESOURCE
+#  endif
+#endif
+
 #include <plf_list.h>
 
 #include <algorithm>
+#include <cstddef>
 #include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
 
 #ifdef GCH_IMPL_THREE_WAY_COMPARISON
 #  if defined (__has_include) && __has_include (<compare>)
@@ -130,6 +146,145 @@ namespace gch
 
   }
 
+  namespace storage
+  {
+
+    // Selects the container a tracker uses to store its reporters. The container
+    // must keep iterators stable across insertion and erasure of other elements,
+    // and must provide the list interface used by `detail::tracker_base`
+    // (emplace, insert, erase, splice, merge, sort, remove_if), along with
+    // `reserve (n)`, `capacity ()`, `trim ()`, which frees unused memory without
+    // moving any elements, and `shrink_to_fit ()`, which may relocate them.
+    //
+    // `iterator_type` and `const_iterator_type` must be nameable while T is
+    // still incomplete, since T holds iterators into the remote container.
+    //
+    // `is_splice_stable` states whether iterators also survive moving, swapping,
+    // and splicing the container. If not, the tracker will update the positions
+    // held by its remotes after each of those operations.
+    //
+    // `is_indexed` states whether the container provides `index_of (pos)`, which
+    // is then used in place of `std::distance` to find reporter positions.
+    //
+    // `is_hashed` states whether the container provides `find (remote_ptr)` and
+    // `modify (element, f)`, which keep an index of the reporters by remote.
+    //
+    // `is_tombstoned` states whether the container provides `kill (pos)`, which
+    // marks an element as dead without a lock, and `compact ()`, which erases
+    // the dead elements. `begin ()` compacts, so iteration skips dead elements.
+    //
+    // `is_compact` states whether reporters hold a 32-bit slot index into the
+    // container (see `handle_of (pos)` and `at (handle)`) and a 32-bit id of
+    // their tracker in place of an iterator and a pointer.
+    //
+    // `is_sorted` states whether the container keeps its elements ordered by
+    // remote, placing each insertion itself and treating `splice` as `merge`.
+    // It provides `lower_bound (remote_ptr)`, `is_sorted ()`, and the `find` and
+    // `modify` of a hashed container.
+    //
+    // `is_instrumented` states whether the tracker counts what it does in
+    // the registry of gch::tracker_stats.
+    //
+    // `is_linked` states whether the nodes of the container are kept inside of
+    // the remote reporters rather than allocated by the container, in which
+    // case each element provides `get_link ()`, which returns its node, and the
+    // container provides `relink (node)` and a `splice` of a range in place of
+    // `insert`.
+    //
+    // `is_paired` states whether the container allocates the nodes for both ends
+    // of a binding between trackers at once, with `emplace_pair`, and provides
+    // a `splice` of a range in place of `insert`.
+    //
+    // `edge_data_type` is the type of the data which each element keeps about
+    // its binding (see storage::with_edge_data), or void if there is none.
+    //
+    // `lock_type` is the lock which a tracker holds while it modifies its
+    // container, or void if it should not lock at all. Readers hold it shared
+    // (see detail::shared_spinlock).
+    //
+    // A leaf storage takes an allocator, which is rebound to the element type of
+    // its container. A tracker may be constructed with an instance of it. If two
+    // trackers have allocators which compare unequal, moves, swaps, splices, and
+    // merges between them copy the reporters over one at a time (unless the
+    // allocator propagates on move assignment), since their nodes may not be
+    // exchanged. Each tracker keeps its own allocator, so a tracker in an arena
+    // never hands its nodes to a tracker outside of it.
+    template <template <typename ...> class Container,
+              typename Allocator = std::allocator<void>>
+    struct basic_list
+    {
+      template <typename T>
+      using container_type = Container<
+        T, typename std::allocator_traits<Allocator>::template rebind_alloc<T>>;
+
+      template <typename T>
+      using iterator_type = typename container_type<T>::iterator;
+
+      template <typename T>
+      using const_iterator_type = typename container_type<T>::const_iterator;
+
+      using is_splice_stable = std::true_type;
+      using is_indexed       = std::false_type;
+      using is_hashed        = std::false_type;
+      using is_tombstoned    = std::false_type;
+      using is_compact       = std::false_type;
+      using is_sorted        = std::false_type;
+      using is_instrumented  = std::false_type;
+      using is_linked        = std::false_type;
+      using is_paired        = std::false_type;
+      using edge_data_type   = void;
+      using lock_type        = void;
+    };
+
+    using list = basic_list<plf::list>;
+
+#ifdef GCH_LIB_MEMORY_RESOURCE
+    namespace pmr
+    {
+
+      using list = basic_list<plf::list, std::pmr::polymorphic_allocator<std::byte>>;
+
+    } // namespace gch::storage::pmr
+#endif
+
+    // Wraps another storage so that the tracker keeps an `EdgeData` inline with
+    // each of its reporters, on the same node as the link to the remote. It is
+    // value-initialized when a binding is made, follows the binding when it is
+    // moved between trackers, and is reached with `edge ()` on an iterator of
+    // the tracker or on a reporter bound to it. Between two trackers, each end
+    // of a binding keeps the data of its own storage.
+    template <typename EdgeData, typename Base = list>
+    struct with_edge_data
+    {
+      static_assert (std::is_same<typename Base::edge_data_type, void>::value,
+                     "storage already has edge data");
+      static_assert (! Base::is_linked::value || std::is_trivially_copyable<EdgeData>::value,
+                     "edge data kept inside of reporters must be trivially copyable");
+
+      template <typename T>
+      using container_type = typename Base::template container_type<T>;
+
+      template <typename T>
+      using iterator_type = typename Base::template iterator_type<T>;
+
+      template <typename T>
+      using const_iterator_type = typename Base::template const_iterator_type<T>;
+
+      using is_splice_stable = typename Base::is_splice_stable;
+      using is_indexed       = typename Base::is_indexed;
+      using is_hashed        = typename Base::is_hashed;
+      using is_tombstoned    = typename Base::is_tombstoned;
+      using is_compact       = typename Base::is_compact;
+      using is_sorted        = typename Base::is_sorted;
+      using is_instrumented  = typename Base::is_instrumented;
+      using is_linked        = typename Base::is_linked;
+      using is_paired        = typename Base::is_paired;
+      using edge_data_type   = EdgeData;
+      using lock_type        = typename Base::lock_type;
+    };
+
+  } // namespace gch::storage
+
   //////////////
   // defaults //
   //////////////
@@ -141,7 +296,8 @@ namespace gch
 
   template <typename Parent,
             typename RemoteTag,
-            typename IntrusiveTag = tag::nonintrusive>
+            typename IntrusiveTag = tag::nonintrusive,
+            typename Storage      = storage::list>
   class tracker;
 
   template <typename RemoteTag>
@@ -153,13 +309,281 @@ namespace gch
   namespace detail
   {
 
-    template <typename ...Ts>
-    using tracker_container = plf::list<Ts...>;
+    template <typename Storage, typename T>
+    using tracker_container = typename Storage::template container_type<T>;
+
+    // An iterator over the `m_value` members of the nodes of another container.
+    // Used by storage which wraps each element in a node with some bookkeeping.
+    template <typename T, typename BaseIt>
+    class node_value_iterator
+    {
+      using base_iter = BaseIt;
+
+      static constexpr
+      bool
+      is_const = std::is_const<
+        typename std::remove_pointer<
+          typename std::iterator_traits<base_iter>::pointer>::type>::value;
+
+    public:
+      using difference_type   = typename std::iterator_traits<base_iter>::difference_type;
+      using value_type        = T;
+      using pointer           = typename std::conditional<is_const, const T *, T *>::type;
+      using reference         = typename std::conditional<is_const, const T&, T&>::type;
+      using iterator_category = typename std::iterator_traits<base_iter>::iterator_category;
+
+      node_value_iterator            (void)                           = default;
+      node_value_iterator            (const node_value_iterator&)     = default;
+      node_value_iterator            (node_value_iterator&&) noexcept = default;
+      node_value_iterator& operator= (const node_value_iterator&)     = default;
+      node_value_iterator& operator= (node_value_iterator&&) noexcept = default;
+      ~node_value_iterator           (void)                           = default;
+
+      template <typename It,
+                typename std::enable_if<std::is_convertible<It, base_iter>::value
+                                    &&! std::is_same<It, base_iter>::value>::type * = nullptr>
+      /* implicit */
+      node_value_iterator (const node_value_iterator<T, It>& other) noexcept
+        : m_iter (other.base ())
+      { }
+
+      explicit
+      node_value_iterator (base_iter it) noexcept
+        : m_iter (it)
+      { }
+
+      GCH_NODISCARD
+      base_iter
+      base (void) const noexcept
+      {
+        return m_iter;
+      }
+
+      node_value_iterator&
+      operator++ (void) noexcept
+      {
+        ++m_iter;
+        return *this;
+      }
+
+      node_value_iterator
+      operator++ (int) noexcept
+      {
+        return node_value_iterator (m_iter++);
+      }
+
+      node_value_iterator&
+      operator-- (void) noexcept
+      {
+        --m_iter;
+        return *this;
+      }
+
+      node_value_iterator
+      operator-- (int) noexcept
+      {
+        return node_value_iterator (m_iter--);
+      }
+
+      reference
+      operator* (void) const noexcept
+      {
+        return m_iter->m_value;
+      }
+
+      pointer
+      operator-> (void) const noexcept
+      {
+        return &m_iter->m_value;
+      }
+
+      friend
+      bool
+      operator== (const node_value_iterator& lhs, const node_value_iterator& rhs) noexcept
+      {
+        return lhs.m_iter == rhs.m_iter;
+      }
+
+      friend
+      bool
+      operator!= (const node_value_iterator& lhs, const node_value_iterator& rhs) noexcept
+      {
+        return lhs.m_iter != rhs.m_iter;
+      }
+
+    private:
+      base_iter m_iter;
+    };
+
+    // An iterator over elements which lie a fixed number of bytes apart, such as
+    // nodes which were allocated one after another (see gch::tracker_segment).
+    template <typename T>
+    class strided_iterator
+    {
+      using byte_pointer = typename std::conditional<std::is_const<T>::value,
+                                                     const unsigned char *,
+                                                     unsigned char *>::type;
+
+    public:
+      using difference_type   = std::ptrdiff_t;
+      using value_type        = typename std::remove_const<T>::type;
+      using pointer           = T *;
+      using reference         = T&;
+      using iterator_category = std::random_access_iterator_tag;
+
+      strided_iterator            (void)                        = default;
+      strided_iterator            (const strided_iterator&)     = default;
+      strided_iterator            (strided_iterator&&) noexcept = default;
+      strided_iterator& operator= (const strided_iterator&)     = default;
+      strided_iterator& operator= (strided_iterator&&) noexcept = default;
+      ~strided_iterator           (void)                        = default;
+
+      strided_iterator (pointer p, difference_type stride) noexcept
+        : m_ptr    (reinterpret_cast<byte_pointer> (p)),
+          m_stride (stride)
+      { }
+
+      strided_iterator&
+      operator++ (void) noexcept
+      {
+        m_ptr += m_stride;
+        return *this;
+      }
+
+      strided_iterator
+      operator++ (int) noexcept
+      {
+        strided_iterator ret (*this);
+        ++*this;
+        return ret;
+      }
+
+      strided_iterator&
+      operator-- (void) noexcept
+      {
+        m_ptr -= m_stride;
+        return *this;
+      }
+
+      strided_iterator
+      operator-- (int) noexcept
+      {
+        strided_iterator ret (*this);
+        --*this;
+        return ret;
+      }
+
+      strided_iterator&
+      operator+= (difference_type n) noexcept
+      {
+        m_ptr += n * m_stride;
+        return *this;
+      }
+
+      strided_iterator&
+      operator-= (difference_type n) noexcept
+      {
+        m_ptr -= n * m_stride;
+        return *this;
+      }
+
+      friend
+      strided_iterator
+      operator+ (strided_iterator it, difference_type n) noexcept
+      {
+        return it += n;
+      }
+
+      friend
+      strided_iterator
+      operator+ (difference_type n, strided_iterator it) noexcept
+      {
+        return it += n;
+      }
+
+      friend
+      strided_iterator
+      operator- (strided_iterator it, difference_type n) noexcept
+      {
+        return it -= n;
+      }
+
+      friend
+      difference_type
+      operator- (const strided_iterator& lhs, const strided_iterator& rhs) noexcept
+      {
+        return (lhs.m_ptr - rhs.m_ptr) / lhs.m_stride;
+      }
+
+      reference
+      operator* (void) const noexcept
+      {
+        return *operator-> ();
+      }
+
+      pointer
+      operator-> (void) const noexcept
+      {
+        return reinterpret_cast<pointer> (m_ptr);
+      }
+
+      reference
+      operator[] (difference_type n) const noexcept
+      {
+        return *(*this + n);
+      }
+
+      friend
+      bool
+      operator== (const strided_iterator& lhs, const strided_iterator& rhs) noexcept
+      {
+        return lhs.m_ptr == rhs.m_ptr;
+      }
+
+      friend
+      bool
+      operator!= (const strided_iterator& lhs, const strided_iterator& rhs) noexcept
+      {
+        return lhs.m_ptr != rhs.m_ptr;
+      }
+
+      friend
+      bool
+      operator< (const strided_iterator& lhs, const strided_iterator& rhs) noexcept
+      {
+        return (lhs.m_ptr - rhs.m_ptr) / lhs.m_stride < 0;
+      }
+
+      friend
+      bool
+      operator> (const strided_iterator& lhs, const strided_iterator& rhs) noexcept
+      {
+        return rhs < lhs;
+      }
+
+      friend
+      bool
+      operator<= (const strided_iterator& lhs, const strided_iterator& rhs) noexcept
+      {
+        return ! (rhs < lhs);
+      }
+
+      friend
+      bool
+      operator>= (const strided_iterator& lhs, const strided_iterator& rhs) noexcept
+      {
+        return ! (lhs < rhs);
+      }
+
+    private:
+      byte_pointer    m_ptr;
+      difference_type m_stride;
+    };
 
     template <typename LocalBaseTag, typename RemoteBaseTag>
     class reporter_base;
 
-    template <typename RemoteBaseTag>
+    template <typename RemoteBaseTag, typename Storage = storage::list>
     class tracker_base;
 
     template <typename Interface>
@@ -188,25 +612,35 @@ namespace gch
         using base_type = detail::reporter_base<LocalBaseTag, RemoteBaseTag>;
       };
 
-      struct tracker_base
+      template <typename Storage>
+      struct basic_tracker_base
       {
-        using base_tag = tracker_base;
+        using base_tag     = basic_tracker_base;
+        using storage_type = Storage;
 
         template <typename, typename RemoteBaseTag>
-        using reporter_type = detail::reporter_base<detail::tag::tracker_base, RemoteBaseTag>;
+        using reporter_type = detail::reporter_base<basic_tracker_base, RemoteBaseTag>;
 
         template <typename RemoteBaseTag>
-        using access_type = typename tracker_container<
-          reporter_type<detail::tag::tracker_base, RemoteBaseTag>>::iterator;
+        using access_type = typename Storage::template iterator_type<
+          reporter_type<basic_tracker_base, RemoteBaseTag>>;
 
         template <typename RemoteBaseTag>
-        using const_access_type = typename tracker_container<
-          reporter_type<detail::tag::tracker_base, RemoteBaseTag>>::const_iterator;
+        using const_access_type = typename Storage::template const_iterator_type<
+          reporter_type<basic_tracker_base, RemoteBaseTag>>;
 
         template <typename, typename RemoteBaseTag>
-        using base_type = detail::tracker_base<RemoteBaseTag>;
+        using base_type = detail::tracker_base<RemoteBaseTag, Storage>;
       };
 
+      using tracker_base = basic_tracker_base<storage::list>;
+
+      template <typename BaseTag>
+      struct is_tracker_base : std::false_type { };
+
+      template <typename Storage>
+      struct is_tracker_base<basic_tracker_base<Storage>> : std::true_type { };
+
       template <typename Parent, typename IntrusiveTag>
       struct reporter
         : reporter_base
@@ -223,9 +657,9 @@ namespace gch
         using common_type = detail::reporter_common<interface_type<RemoteTag>>;
       };
 
-      template <typename Parent, typename IntrusiveTag>
+      template <typename Parent, typename IntrusiveTag, typename Storage = storage::list>
       struct tracker
-        : tracker_base
+        : basic_tracker_base<Storage>
       {
         using reduced_tag = tracker;
 
@@ -233,7 +667,7 @@ namespace gch
         using parent_type = Parent;
 
         template <typename RemoteTag>
-        using interface_type = gch::tracker<Parent, RemoteTag, IntrusiveTag>;
+        using interface_type = gch::tracker<Parent, RemoteTag, IntrusiveTag, Storage>;
 
         template <typename RemoteTag>
         using common_type = detail::tracker_common<interface_type<RemoteTag>>;
@@ -296,8 +730,8 @@ namespace gch
       struct is_tracker : std::false_type { };
 
       template <typename Tag>
-      struct is_tracker<Tag, typename std::enable_if<std::is_base_of<detail::tag::tracker_base,
-                                                                     Tag>::value>::type>
+      struct is_tracker<Tag, typename std::enable_if<
+                               is_tracker_base<typename Tag::base_tag>::value>::type>
         : std::true_type
       { };
 
@@ -320,8 +754,8 @@ namespace gch
     template <typename Parent>
     using reporter = detail::tag::reporter<Parent, tag::nonintrusive>;
 
-    template <typename Parent>
-    using tracker = detail::tag::tracker<Parent, tag::nonintrusive>;
+    template <typename Parent, typename Storage = storage::list>
+    using tracker = detail::tag::tracker<Parent, tag::nonintrusive, Storage>;
 
     using standalone_reporter = detail::tag::standalone_reporter;
     using standalone_tracker  = detail::tag::standalone_tracker;
@@ -329,8 +763,8 @@ namespace gch
     template <typename Derived>
     using intrusive_reporter = detail::tag::reporter<Derived, tag::intrusive>;
 
-    template <typename Derived>
-    using intrusive_tracker = detail::tag::tracker<Derived, tag::intrusive>;
+    template <typename Derived, typename Storage = storage::list>
+    using intrusive_tracker = detail::tag::tracker<Derived, tag::intrusive, Storage>;
 
     namespace intrusive
     {
@@ -387,11 +821,102 @@ namespace gch
       parent_type& m_parent;
     };
 
+    //! hints that `p` is about to be written to
+    inline
+    void
+    prefetch_for_write (const void *p) noexcept
+    {
+#if defined (__GNUC__) || defined (__clang__)
+      __builtin_prefetch (p, 1);
+#else
+      static_cast<void> (p);
+#endif
+    }
+
+    // The parent of an interface may define `on_debind (Interface&)` and
+    // `on_rebind (Interface&)` to be told when the other end of a binding takes
+    // away or gives it a remote, so that it need not poll `has_remote ()`. The
+    // hooks are found at compile time, and cost nothing where they are absent.
+    // They are called after the binding has changed, and must not throw.
+    template <typename Interface, typename = void>
+    struct has_debind_hook
+      : std::false_type
+    { };
+
+    template <typename Interface>
+    struct has_debind_hook<Interface, decltype (static_cast<void> (
+      std::declval<Interface&> ().get_parent ().on_debind (std::declval<Interface&> ())))>
+      : std::true_type
+    { };
+
+    template <typename Interface, typename = void>
+    struct has_rebind_hook
+      : std::false_type
+    { };
+
+    template <typename Interface>
+    struct has_rebind_hook<Interface, decltype (static_cast<void> (
+      std::declval<Interface&> ().get_parent ().on_rebind (std::declval<Interface&> ())))>
+      : std::true_type
+    { };
+
+    template <typename Interface>
+    void
+    notify_debind (Interface& i, std::true_type) noexcept
+    {
+      i.get_parent ().on_debind (i);
+    }
+
+    template <typename Interface>
+    void
+    notify_debind (Interface&, std::false_type) noexcept
+    { }
+
+    //! calls `on_debind` on the parent of `i` if it has one
+    template <typename Interface>
+    void
+    notify_debind (Interface& i) noexcept
+    {
+      notify_debind (i, has_debind_hook<Interface> { });
+    }
+
+    template <typename Interface>
+    void
+    notify_rebind (Interface& i, std::true_type) noexcept
+    {
+      i.get_parent ().on_rebind (i);
+    }
+
+    template <typename Interface>
+    void
+    notify_rebind (Interface&, std::false_type) noexcept
+    { }
+
+    //! calls `on_rebind` on the parent of `i` if it has one
+    template <typename Interface>
+    void
+    notify_rebind (Interface& i) noexcept
+    {
+      notify_rebind (i, has_rebind_hook<Interface> { });
+    }
+
+    // passed to tracker_base where no remote needs to be told of a debinding
+    struct ignore_debind
+    {
+      template <typename RemoteBase>
+      void
+      operator() (RemoteBase&) const noexcept
+      { }
+    };
+
   } // namespace gch::detail
 
   template <typename T>
   struct tracker_traits;
 
+  template <typename Reporter, typename RemoteType, typename RemoteInterfaceType>
+  class tracker_segment;
+
   // pretend like reporter_base doesn't exist
   template <typename ReporterIt, typename RemoteType, typename RemoteInterfaceType>
   class tracker_iterator
@@ -444,6 +969,9 @@ namespace gch
     template <typename It, typename T, typename I>
     friend class tracker_iterator;
 
+    template <typename R, typename T, typename I>
+    friend class tracker_segment;
+
     explicit
     tracker_iterator (reporter_iter it)
         : m_iter (it)
@@ -482,6 +1010,84 @@ namespace gch
       return iter_common (m_iter--);
     }
 
+    // the rest are only for random-access reporter iterators
+
+    tracker_iterator&
+    operator+= (difference_type n) noexcept
+    {
+      m_iter += n;
+      return *this;
+    }
+
+    tracker_iterator&
+    operator-= (difference_type n) noexcept
+    {
+      m_iter -= n;
+      return *this;
+    }
+
+    friend
+    tracker_iterator
+    operator+ (tracker_iterator it, difference_type n) noexcept
+    {
+      return it += n;
+    }
+
+    friend
+    tracker_iterator
+    operator+ (difference_type n, tracker_iterator it) noexcept
+    {
+      return it += n;
+    }
+
+    friend
+    tracker_iterator
+    operator- (tracker_iterator it, difference_type n) noexcept
+    {
+      return it -= n;
+    }
+
+    friend
+    difference_type
+    operator- (const tracker_iterator& lhs, const tracker_iterator& rhs) noexcept
+    {
+      return lhs.m_iter - rhs.m_iter;
+    }
+
+    reference
+    operator[] (difference_type n) const noexcept
+    {
+      return *(*this + n);
+    }
+
+    friend
+    bool
+    operator< (const tracker_iterator& lhs, const tracker_iterator& rhs) noexcept
+    {
+      return lhs.m_iter < rhs.m_iter;
+    }
+
+    friend
+    bool
+    operator> (const tracker_iterator& lhs, const tracker_iterator& rhs) noexcept
+    {
+      return rhs < lhs;
+    }
+
+    friend
+    bool
+    operator<= (const tracker_iterator& lhs, const tracker_iterator& rhs) noexcept
+    {
+      return ! (rhs < lhs);
+    }
+
+    friend
+    bool
+    operator>= (const tracker_iterator& lhs, const tracker_iterator& rhs) noexcept
+    {
+      return ! (lhs < rhs);
+    }
+
     friend
     bool
     operator== (const tracker_iterator& lhs, const tracker_iterator& rhs) noexcept
@@ -528,10 +1134,81 @@ namespace gch
       return static_cast<remote_interface_type&> (m_iter->get_remote_base ());
     }
 
+    //! the data which the tracker keeps about this binding (see storage::with_edge_data)
+    template <typename It = reporter_iter>
+    constexpr
+    auto
+    get_edge (void) const noexcept
+      -> decltype (std::declval<It&> ()->get_edge ())
+    {
+      return m_iter->get_edge ();
+    }
+
   private:
     reporter_iter m_iter;
   };
 
+  // A run of the bindings of a tracker whose nodes lie evenly spaced in memory
+  // (see `for_each_segment`). Loops over it step by a fixed stride rather than
+  // following links, so they may be unrolled, and remotes further along may be
+  // found (and prefetched) without visiting the ones in between.
+  template <typename Reporter, typename RemoteType, typename RemoteInterfaceType>
+  class tracker_segment
+  {
+    using reporter_iter = detail::strided_iterator<const Reporter>;
+
+  public:
+    using value_type      = RemoteType;
+    using size_type       = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference       = RemoteType&;
+    using iterator        = tracker_iterator<reporter_iter, RemoteType, RemoteInterfaceType>;
+
+    tracker_segment            (void)                       = delete;
+    tracker_segment            (const tracker_segment&)     = default;
+    tracker_segment            (tracker_segment&&) noexcept = default;
+    tracker_segment& operator= (const tracker_segment&)     = default;
+    tracker_segment& operator= (tracker_segment&&) noexcept = default;
+    ~tracker_segment           (void)                       = default;
+
+    tracker_segment (const Reporter *first, size_type size, difference_type stride) noexcept
+      : m_first (first, stride),
+        m_size  (size)
+    { }
+
+    GCH_NODISCARD
+    iterator
+    begin (void) const noexcept
+    {
+      return iterator (m_first);
+    }
+
+    GCH_NODISCARD
+    iterator
+    end (void) const noexcept
+    {
+      return iterator (m_first + static_cast<difference_type> (m_size));
+    }
+
+    GCH_NODISCARD
+    size_type
+    size (void) const noexcept
+    {
+      return m_size;
+    }
+
+    GCH_NODISCARD
+    reference
+    operator[] (size_type i) const noexcept
+    {
+      return begin ()[static_cast<difference_type> (i)];
+    }
+
+  private:
+    reporter_iter m_first;
+    size_type     m_size;
+  };
+
 } // namespace gch
 
 #endif // GCH_TRACKER_COMMON_HPP
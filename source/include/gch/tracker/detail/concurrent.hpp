@@ -0,0 +1,339 @@
+/** concurrent.hpp
+ * Copyright © 2021 Gene Harvey
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license. See the LICENSE file for details.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GCH_TRACKER_CONCURRENT_HPP
+#define GCH_TRACKER_CONCURRENT_HPP
+
+#include "common.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+
+namespace gch
+{
+
+  namespace detail
+  {
+
+    /////////////////////
+    // shared_spinlock //
+    /////////////////////
+
+    // A spinlock which may also be held by any number of readers at once. A
+    // waiting writer stops new readers from entering, so writers can't starve.
+    class shared_spinlock
+    {
+    public:
+      shared_spinlock            (void)                       = default;
+      shared_spinlock            (const shared_spinlock&)     = delete;
+      shared_spinlock            (shared_spinlock&&) noexcept = delete;
+      shared_spinlock& operator= (const shared_spinlock&)     = delete;
+      shared_spinlock& operator= (shared_spinlock&&) noexcept = delete;
+      ~shared_spinlock           (void)                       = default;
+
+      void
+      lock (void) noexcept
+      {
+        std::size_t state = m_state.load (std::memory_order_relaxed);
+        while (true)
+        {
+          if ((state & ~pending_bit) == 0)
+          {
+            if (m_state.compare_exchange_weak (state, writer_bit, std::memory_order_acquire,
+                                               std::memory_order_relaxed))
+              return;
+          }
+          else
+          {
+            if ((state & pending_bit) == 0)
+              m_state.fetch_or (pending_bit, std::memory_order_relaxed);
+            state = m_state.load (std::memory_order_relaxed);
+          }
+        }
+      }
+
+      void
+      unlock (void) noexcept
+      {
+        m_state.fetch_and (~writer_bit, std::memory_order_release);
+      }
+
+      void
+      lock_shared (void) noexcept
+      {
+        std::size_t state = m_state.load (std::memory_order_relaxed);
+        while (true)
+        {
+          if ((state & (writer_bit | pending_bit)) != 0)
+            state = m_state.load (std::memory_order_relaxed);
+          else if (m_state.compare_exchange_weak (state, state + reader_unit))
+            return;
+        }
+      }
+
+      void
+      unlock_shared (void) noexcept
+      {
+        m_state.fetch_sub (reader_unit, std::memory_order_release);
+      }
+
+      GCH_NODISCARD
+      bool
+      has_readers (void) const noexcept
+      {
+        return (m_state.load () & ~(writer_bit | pending_bit)) != 0;
+      }
+
+    private:
+      static constexpr std::size_t writer_bit  = 1;
+      static constexpr std::size_t pending_bit = 2;
+      static constexpr std::size_t reader_unit = 4;
+
+      std::atomic<std::size_t> m_state { 0 };
+    };
+
+    ////////////////////
+    // reporters_lock //
+    ////////////////////
+
+    // The lock a tracker holds while it modifies its reporters. Trackers get a
+    // new lock when they are moved. This is empty if Lock is void.
+    template <typename Lock>
+    class reporters_lock
+    {
+    public:
+      reporters_lock            (void)                      = default;
+//    reporters_lock            (const reporters_lock&)     = impl;
+//    reporters_lock            (reporters_lock&&) noexcept = impl;
+//    reporters_lock& operator= (const reporters_lock&)     = impl;
+//    reporters_lock& operator= (reporters_lock&&) noexcept = impl;
+      ~reporters_lock           (void)                      = default;
+
+      reporters_lock (const reporters_lock&) noexcept
+      { }
+
+      reporters_lock&
+      operator= (const reporters_lock&) noexcept
+      {
+        return *this;
+      }
+
+      void
+      lock_reporters (void) const noexcept
+      {
+        m_lock.lock ();
+      }
+
+      void
+      unlock_reporters (void) const noexcept
+      {
+        m_lock.unlock ();
+      }
+
+      void
+      lock_shared_reporters (void) const noexcept
+      {
+        m_lock.lock_shared ();
+      }
+
+      void
+      unlock_shared_reporters (void) const noexcept
+      {
+        m_lock.unlock_shared ();
+      }
+
+      // Waits until no reader can still be looking at a reporter which was
+      // marked dead before this call. Taking the lock shuts out new readers.
+      void
+      synchronize_reporters (void) const noexcept
+      {
+        if (m_lock.has_readers ())
+        {
+          m_lock.lock ();
+          m_lock.unlock ();
+        }
+      }
+
+    private:
+      mutable Lock m_lock;
+    };
+
+    template <>
+    class reporters_lock<void>
+    {
+    public:
+      void lock_reporters          (void) const noexcept { }
+      void unlock_reporters        (void) const noexcept { }
+      void lock_shared_reporters   (void) const noexcept { }
+      void unlock_shared_reporters (void) const noexcept { }
+      void synchronize_reporters   (void) const noexcept { }
+    };
+
+    /////////////////////
+    // reporters_guard //
+    /////////////////////
+
+    template <typename Tracker>
+    class reporters_guard
+    {
+    public:
+      reporters_guard            (void)                       = delete;
+      reporters_guard            (const reporters_guard&)     = delete;
+      reporters_guard            (reporters_guard&&) noexcept = delete;
+      reporters_guard& operator= (const reporters_guard&)     = delete;
+      reporters_guard& operator= (reporters_guard&&) noexcept = delete;
+//    ~reporters_guard           (void)                       = impl;
+
+      explicit
+      reporters_guard (const Tracker& t) noexcept
+        : m_tracker (t)
+      {
+        m_tracker.lock_reporters ();
+      }
+
+      ~reporters_guard (void)
+      {
+        m_tracker.unlock_reporters ();
+      }
+
+    private:
+      const Tracker& m_tracker;
+    };
+
+    template <typename Tracker>
+    class reporters_shared_guard
+    {
+    public:
+      reporters_shared_guard            (void)                              = delete;
+      reporters_shared_guard            (const reporters_shared_guard&)     = delete;
+      reporters_shared_guard            (reporters_shared_guard&&) noexcept = delete;
+      reporters_shared_guard& operator= (const reporters_shared_guard&)     = delete;
+      reporters_shared_guard& operator= (reporters_shared_guard&&) noexcept = delete;
+//    ~reporters_shared_guard           (void)                              = impl;
+
+      explicit
+      reporters_shared_guard (const Tracker& t) noexcept
+        : m_tracker (t)
+      {
+        m_tracker.lock_shared_reporters ();
+      }
+
+      ~reporters_shared_guard (void)
+      {
+        m_tracker.unlock_shared_reporters ();
+      }
+
+    private:
+      const Tracker& m_tracker;
+    };
+
+    // Locks two trackers in order of address, so that two threads binding the
+    // same pair of trackers from opposite ends cannot deadlock. If both are the
+    // same tracker, it is only locked once.
+    template <typename Tracker, typename RemoteTracker>
+    class reporters_pair_guard
+    {
+    public:
+      reporters_pair_guard            (void)                            = delete;
+      reporters_pair_guard            (const reporters_pair_guard&)     = delete;
+      reporters_pair_guard            (reporters_pair_guard&&) noexcept = delete;
+      reporters_pair_guard& operator= (const reporters_pair_guard&)     = delete;
+      reporters_pair_guard& operator= (reporters_pair_guard&&) noexcept = delete;
+//    ~reporters_pair_guard           (void)                            = impl;
+
+      reporters_pair_guard (const Tracker& t, const RemoteTracker& r) noexcept
+        : m_tracker        (t),
+          m_remote_tracker (r)
+      {
+        if (is_same ())
+          m_tracker.lock_reporters ();
+        else if (std::less<const void *> { } (&m_tracker, &m_remote_tracker))
+        {
+          m_tracker.lock_reporters ();
+          m_remote_tracker.lock_reporters ();
+        }
+        else
+        {
+          m_remote_tracker.lock_reporters ();
+          m_tracker.lock_reporters ();
+        }
+      }
+
+      ~reporters_pair_guard (void)
+      {
+        if (! is_same ())
+          m_remote_tracker.unlock_reporters ();
+        m_tracker.unlock_reporters ();
+      }
+
+    private:
+      GCH_NODISCARD
+      bool
+      is_same (void) const noexcept
+      {
+        return static_cast<const void *> (&m_tracker)
+           ==  static_cast<const void *> (&m_remote_tracker);
+      }
+
+      const Tracker&       m_tracker;
+      const RemoteTracker& m_remote_tracker;
+    };
+
+  } // namespace gch::detail
+
+  namespace storage
+  {
+
+    // Wraps another storage so that each tracker guards its reporters with a
+    // spinlock. Reporters bound to the same tracker may then be bound (with
+    // `tag::bind` or `rebind`), debound, and destroyed from several threads at
+    // once, and trackers may be bound to each other (with `push_back`) and
+    // debound from several threads at once.
+    //
+    // Each binding must still only be used by one thread at a time. Anything
+    // which walks or restructures a whole tracker (iteration, lookups,
+    // positional insertion, clear, splice, merge, sort, moves, swaps, and
+    // destruction) must still be synchronized externally.
+    //
+    // With `concurrent<tombstoned<>>`, reporters detach themselves without
+    // taking the lock at all (see storage::tombstoned).
+    //
+    // `for_each_remote` may be run from several threads at once, and alongside
+    // the operations above. Binding waits for the readers to finish. With
+    // tombstoned storage, detaching only waits if a reader is active, so that
+    // no reader is left holding a reporter which has been destroyed.
+    template <typename Base = list>
+    struct concurrent
+    {
+      template <typename T>
+      using container_type = typename Base::template container_type<T>;
+
+      template <typename T>
+      using iterator_type = typename Base::template iterator_type<T>;
+
+      template <typename T>
+      using const_iterator_type = typename Base::template const_iterator_type<T>;
+
+      using is_splice_stable = typename Base::is_splice_stable;
+      using is_indexed       = typename Base::is_indexed;
+      using is_hashed        = typename Base::is_hashed;
+      using is_tombstoned    = typename Base::is_tombstoned;
+      using is_compact       = typename Base::is_compact;
+      using is_sorted        = typename Base::is_sorted;
+      using is_instrumented  = typename Base::is_instrumented;
+      using is_linked        = typename Base::is_linked;
+      using is_paired        = typename Base::is_paired;
+      using edge_data_type   = typename Base::edge_data_type;
+      using lock_type        = detail::shared_spinlock;
+    };
+
+  } // namespace gch::storage
+
+} // namespace gch
+
+#endif // GCH_TRACKER_CONCURRENT_HPP
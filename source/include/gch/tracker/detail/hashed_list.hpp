@@ -0,0 +1,607 @@
+/** hashed_list.hpp
+ * Copyright © 2021 Gene Harvey
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license. See the LICENSE file for details.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GCH_TRACKER_HASHED_LIST_HPP
+#define GCH_TRACKER_HASHED_LIST_HPP
+
+#include "common.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace gch
+{
+
+  namespace detail
+  {
+
+    //////////////////
+    // remote_index //
+    //////////////////
+
+    // An open-addressing multimap from remote pointers to positions. Uses
+    // linear probing with backward-shift deletion, so there are no tombstones
+    // and erasure never allocates. Insertion requires a prior `reserve`.
+    template <typename Iterator, typename Allocator>
+    class remote_index
+    {
+      struct slot
+      {
+        const void *m_key = nullptr;
+        Iterator    m_pos;
+      };
+
+      using slot_allocator = typename std::allocator_traits<Allocator>::template
+                               rebind_alloc<slot>;
+      using slot_vector    = std::vector<slot, slot_allocator>;
+
+    public:
+      using size_type = std::size_t;
+
+      remote_index            (void)                    = default;
+      remote_index            (const remote_index&)     = delete;
+      remote_index            (remote_index&&) noexcept = default;
+      remote_index& operator= (const remote_index&)     = delete;
+      remote_index& operator= (remote_index&&) noexcept = default;
+      ~remote_index           (void)                    = default;
+
+      explicit
+      remote_index (const Allocator& alloc)
+        : m_slots (slot_allocator (alloc))
+      { }
+
+      void
+      swap (remote_index& other) noexcept
+      {
+        using std::swap;
+        m_slots.swap (other.m_slots);
+        swap (m_size, other.m_size);
+        swap (m_shift, other.m_shift);
+      }
+
+      GCH_NODISCARD
+      size_type
+      size (void) const noexcept
+      {
+        return m_size;
+      }
+
+      //! makes room for `n` entries in total; the only operation which allocates
+      void
+      reserve (size_type n)
+      {
+        if (m_slots.size () < 2 * n)
+          rehash (2 * n);
+      }
+
+      //! gives back the slots which are not needed by the current entries
+      void
+      shrink_to_fit (void)
+      {
+        if (m_size == 0)
+        {
+          slot_vector (m_slots.get_allocator ()).swap (m_slots);
+          m_shift = 64;
+        }
+        else if (8 < m_slots.size () && 4 * m_size <= m_slots.size ())
+          rehash (2 * m_size);
+      }
+
+      //! keeps the allocation
+      void
+      clear (void) noexcept
+      {
+        for (slot& s : m_slots)
+          s.m_key = nullptr;
+        m_size = 0;
+      }
+
+      //! requires that room was reserved for the entry
+      void
+      insert (const void *key, const Iterator pos) noexcept
+      {
+        assert (key != nullptr && "reporters must be tracking a remote to be indexed");
+        assert (2 * (m_size + 1) <= m_slots.size () && "room was not reserved");
+
+        size_type i = home (key);
+        while (m_slots[i].m_key != nullptr)
+          i = next (i);
+        m_slots[i].m_key = key;
+        m_slots[i].m_pos = pos;
+        ++m_size;
+      }
+
+      //! removes the entry for the element at `addr`, which must be indexed under `key`
+      Iterator
+      erase (const void *key, const void *addr) noexcept
+      {
+        size_type i = home (key);
+        while (m_slots[i].m_key != key || &*m_slots[i].m_pos != addr)
+        {
+          assert (m_slots[i].m_key != nullptr && "the element was not indexed");
+          i = next (i);
+        }
+
+        const Iterator ret = m_slots[i].m_pos;
+
+        // shift back any later entries which would no longer be reachable
+        for (size_type j = next (i); m_slots[j].m_key != nullptr; j = next (j))
+        {
+          const size_type h = home (m_slots[j].m_key);
+          if (((j - h) & mask ()) >= ((j - i) & mask ()))
+          {
+            m_slots[i] = m_slots[j];
+            i = j;
+          }
+        }
+
+        m_slots[i].m_key = nullptr;
+        --m_size;
+        return ret;
+      }
+
+      //! returns some position indexed under `key`, or nullptr if there are none
+      GCH_NODISCARD
+      const Iterator *
+      find (const void *key) const noexcept
+      {
+        if (m_size == 0)
+          return nullptr;
+
+        for (size_type i = home (key); m_slots[i].m_key != nullptr; i = next (i))
+        {
+          if (m_slots[i].m_key == key)
+            return &m_slots[i].m_pos;
+        }
+        return nullptr;
+      }
+
+    private:
+      GCH_NODISCARD
+      size_type
+      mask (void) const noexcept
+      {
+        return m_slots.size () - 1;
+      }
+
+      GCH_NODISCARD
+      size_type
+      next (size_type i) const noexcept
+      {
+        return (i + 1) & mask ();
+      }
+
+      // Fibonacci hashing; the low bits of a pointer are mostly alignment.
+      GCH_NODISCARD
+      size_type
+      home (const void *key) const noexcept
+      {
+        constexpr std::uint64_t mult = 0x9E3779B97F4A7C15ULL;
+        const auto k = static_cast<std::uint64_t> (reinterpret_cast<std::uintptr_t> (key));
+        return static_cast<size_type> ((k * mult) >> m_shift);
+      }
+
+      void
+      rehash (size_type n)
+      {
+        size_type cap   = 8;
+        unsigned  shift = 61;
+        while (cap < n)
+        {
+          cap *= 2;
+          --shift;
+        }
+
+        slot_vector old (cap, slot { }, m_slots.get_allocator ());
+        old.swap (m_slots);
+        m_shift = shift;
+        m_size  = 0;
+
+        for (const slot& s : old)
+          if (s.m_key != nullptr)
+            insert (s.m_key, s.m_pos);
+      }
+
+      slot_vector m_slots;
+      size_type   m_size  = 0;
+      unsigned    m_shift = 64;
+    };
+
+    /////////////////
+    // hashed_list //
+    /////////////////
+
+    // A list which also indexes its reporters by the address of their remotes.
+    // Anything which changes the remote of an element in place must go through
+    // `modify` so that the index stays in sync.
+    template <typename Storage, typename T>
+    class hashed_list
+    {
+      using list_type = tracker_container<Storage, T>;
+
+    public:
+      using value_type             = T;
+      using allocator_type         = typename list_type::allocator_type;
+      using size_type              = typename list_type::size_type;
+      using difference_type        = typename list_type::difference_type;
+      using reference              = typename list_type::reference;
+      using const_reference        = typename list_type::const_reference;
+      using pointer                = typename list_type::pointer;
+      using const_pointer          = typename list_type::const_pointer;
+      using iterator               = typename list_type::iterator;
+      using const_iterator         = typename list_type::const_iterator;
+      using reverse_iterator       = typename list_type::reverse_iterator;
+      using const_reverse_iterator = typename list_type::const_reverse_iterator;
+
+      hashed_list            (void)                   = default;
+      hashed_list            (const hashed_list&)     = delete;
+//    hashed_list            (hashed_list&&) noexcept = impl;
+      hashed_list& operator= (const hashed_list&)     = delete;
+//    hashed_list& operator= (hashed_list&&) noexcept = impl;
+      ~hashed_list           (void)                   = default;
+
+      hashed_list (hashed_list&& other) noexcept
+        : m_list  (std::move (other.m_list)),
+          m_index (std::move (other.m_index))
+      {
+        other.m_index.clear ();
+        relocated ();
+      }
+
+      hashed_list&
+      operator= (hashed_list&& other) noexcept
+      {
+        m_list = std::move (other.m_list);
+        m_index.swap (other.m_index);
+        other.m_index.clear ();
+        relocated ();
+        return *this;
+      }
+
+      explicit
+      hashed_list (const allocator_type& alloc)
+        : m_list  (alloc),
+          m_index (alloc)
+      { }
+
+      void
+      swap (hashed_list& other) noexcept
+      {
+        m_list.swap (other.m_list);
+        m_index.swap (other.m_index);
+        relocated ();
+        other.relocated ();
+      }
+
+      GCH_NODISCARD
+      allocator_type
+      get_allocator (void) const noexcept
+      {
+        return m_list.get_allocator ();
+      }
+
+      GCH_NODISCARD iterator       begin  (void)       noexcept { return m_list.begin ();  }
+      GCH_NODISCARD const_iterator begin  (void) const noexcept { return m_list.begin ();  }
+      GCH_NODISCARD const_iterator cbegin (void) const noexcept { return m_list.cbegin (); }
+
+      GCH_NODISCARD iterator       end    (void)       noexcept { return m_list.end ();    }
+      GCH_NODISCARD const_iterator end    (void) const noexcept { return m_list.end ();    }
+      GCH_NODISCARD const_iterator cend   (void) const noexcept { return m_list.cend ();   }
+
+      GCH_NODISCARD
+      reverse_iterator
+      rbegin (void) noexcept
+      {
+        return m_list.rbegin ();
+      }
+
+      GCH_NODISCARD
+      const_reverse_iterator
+      rbegin (void) const noexcept
+      {
+        return m_list.rbegin ();
+      }
+
+      GCH_NODISCARD
+      const_reverse_iterator
+      crbegin (void) const noexcept
+      {
+        return m_list.crbegin ();
+      }
+
+      GCH_NODISCARD
+      reverse_iterator
+      rend (void) noexcept
+      {
+        return m_list.rend ();
+      }
+
+      GCH_NODISCARD
+      const_reverse_iterator
+      rend (void) const noexcept
+      {
+        return m_list.rend ();
+      }
+
+      GCH_NODISCARD
+      const_reverse_iterator
+      crend (void) const noexcept
+      {
+        return m_list.crend ();
+      }
+
+      GCH_NODISCARD reference       front (void)       { return m_list.front (); }
+      GCH_NODISCARD const_reference front (void) const { return m_list.front (); }
+
+      GCH_NODISCARD reference       back  (void)       { return m_list.back ();  }
+      GCH_NODISCARD const_reference back  (void) const { return m_list.back ();  }
+
+      GCH_NODISCARD
+      bool
+      empty (void) const noexcept
+      {
+        return m_list.empty ();
+      }
+
+      GCH_NODISCARD
+      size_type
+      size (void) const noexcept
+      {
+        return m_list.size ();
+      }
+
+      GCH_NODISCARD
+      size_type
+      max_size (void) const noexcept
+      {
+        return m_list.max_size ();
+      }
+
+      GCH_NODISCARD
+      size_type
+      capacity (void) const noexcept
+      {
+        return m_list.capacity ();
+      }
+
+      //! makes room in the index as well, so that emplacing up to `n` elements never rehashes
+      void
+      reserve (size_type n)
+      {
+        m_index.reserve (n);
+        m_list.reserve (n);
+      }
+
+      void
+      shrink_to_fit (void)
+      {
+        m_index.shrink_to_fit ();
+        m_list.shrink_to_fit ();
+        reindex ();
+      }
+
+      void
+      trim (void) noexcept
+      {
+        m_list.trim ();
+      }
+
+      //! only available if the underlying storage is indexed
+      GCH_NODISCARD
+      size_type
+      index_of (const const_iterator pos) const noexcept
+      {
+        return m_list.index_of (pos);
+      }
+
+      //! returns an element whose remote is at `key`, or `end ()` if there is none
+      GCH_NODISCARD
+      iterator
+      find (const void *key) noexcept
+      {
+        const iterator *pos = m_index.find (key);
+        return pos ? *pos : end ();
+      }
+
+      GCH_NODISCARD
+      const_iterator
+      find (const void *key) const noexcept
+      {
+        const iterator *pos = m_index.find (key);
+        return pos ? const_iterator (*pos) : cend ();
+      }
+
+      //! changes the remote of `e`, which must be an element of `*this`, with `f`
+      template <typename Function>
+      void
+      modify (value_type& e, Function f) noexcept
+      {
+        const iterator pos = m_index.erase (key (e), &e);
+        f (e);
+        m_index.insert (key (e), pos);
+      }
+
+      template <typename ...Args>
+      iterator
+      emplace (const const_iterator pos, Args&&... args)
+      {
+        m_index.reserve (size () + 1);
+        const iterator it = m_list.emplace (pos, std::forward<Args> (args)...);
+        m_index.insert (key (*it), it);
+        return it;
+      }
+
+      template <typename InputIt>
+      iterator
+      insert (const const_iterator pos, InputIt first, const InputIt last)
+      {
+        if (first == last)
+          return m_list.erase (pos, pos);
+
+        const iterator ret = emplace (pos, *first);
+        try
+        {
+          while (++first != last)
+            emplace (pos, *first);
+        }
+        catch (...)
+        {
+          erase (ret, pos);
+          throw;
+        }
+        return ret;
+      }
+
+      iterator
+      erase (const const_iterator pos) noexcept
+      {
+        m_index.erase (key (*pos), &*pos);
+        return m_list.erase (pos);
+      }
+
+      iterator
+      erase (const_iterator first, const const_iterator last) noexcept
+      {
+        for (const_iterator it = first; it != last; ++it)
+          m_index.erase (key (*it), &*it);
+        return m_list.erase (first, last);
+      }
+
+      void
+      clear (void) noexcept
+      {
+        m_index.clear ();
+        m_list.clear ();
+      }
+
+      //! only allocates if `*this` is not empty
+      void
+      splice (const const_iterator pos, hashed_list& other)
+      {
+        if (empty ())
+        {
+          // take the index from `other` along with its elements
+          m_list.splice (pos, other.m_list);
+          m_index.swap (other.m_index);
+          other.m_index.clear ();
+          relocated ();
+          return;
+        }
+
+        m_index.reserve (size () + other.size ());
+
+        const bool at_front = (pos == cbegin ());
+        const const_iterator prev = at_front ? pos : std::prev (pos);
+
+        m_list.splice (pos, other.m_list);
+        other.m_index.clear ();
+
+        iterator it = at_front ? begin () : std::next (m_list.erase (prev, prev));
+        for (const iterator last = m_list.erase (pos, pos); it != last; ++it)
+          m_index.insert (key (*it), it);
+      }
+
+      void
+      merge (hashed_list& other)
+      {
+        m_index.reserve (size () + other.size ());
+        m_list.merge (other.m_list);
+        other.m_index.clear ();
+        reindex ();
+      }
+
+      void
+      sort (void)
+      {
+        m_list.sort ();
+        reindex ();
+      }
+
+      template <typename Pred>
+      void
+      remove_if (Pred pred)
+      {
+        m_list.remove_if (pred);
+        reindex ();
+      }
+
+    private:
+      static
+      const void *
+      key (const value_type& e) noexcept
+      {
+        return e.get_remote_base_ptr ();
+      }
+
+      // only uses the current allocation, since the index is never resized
+      void
+      reindex (void) noexcept
+      {
+        m_index.clear ();
+        for (iterator it = begin (); it != end (); ++it)
+          m_index.insert (key (*it), it);
+      }
+
+      void
+      relocated (void) noexcept
+      {
+        if (! Storage::is_splice_stable::value)
+          reindex ();
+      }
+
+      list_type                              m_list;
+      remote_index<iterator, allocator_type> m_index;
+    };
+
+  } // namespace gch::detail
+
+  namespace storage
+  {
+
+    // Wraps another storage so that the reporters bound to a particular remote
+    // can be found in O(1). This must be the outermost storage policy, i.e.
+    // `hashed<indexed<>>` is fine, but `indexed<hashed<>>` is not.
+    template <typename Base = list>
+    struct hashed
+    {
+      static_assert (! Base::is_tombstoned::value,
+                     "hashed storage may not be tombstoned");
+      static_assert (! Base::is_compact::value, "compact storage may not be wrapped");
+      static_assert (! Base::is_linked::value, "linked storage may not be wrapped");
+      static_assert (! Base::is_paired::value, "paired storage may not be wrapped");
+      static_assert (! Base::is_sorted::value, "sorted storage may not be hashed");
+
+      template <typename T>
+      using container_type = detail::hashed_list<Base, T>;
+
+      template <typename T>
+      using iterator_type = typename Base::template iterator_type<T>;
+
+      template <typename T>
+      using const_iterator_type = typename Base::template const_iterator_type<T>;
+
+      using is_splice_stable = typename Base::is_splice_stable;
+      using is_indexed       = typename Base::is_indexed;
+      using is_hashed        = std::true_type;
+      using is_tombstoned    = std::false_type;
+      using is_compact       = std::false_type;
+      using is_sorted        = std::false_type;
+      using is_instrumented  = typename Base::is_instrumented;
+      using is_linked        = std::false_type;
+      using is_paired        = std::false_type;
+      using edge_data_type   = typename Base::edge_data_type;
+      using lock_type        = typename Base::lock_type;
+    };
+
+  } // namespace gch::storage
+
+} // namespace gch
+
+#endif // GCH_TRACKER_HASHED_LIST_HPP
@@ -0,0 +1,368 @@
+/** indexed_list.hpp
+ * Copyright © 2021 Gene Harvey
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license. See the LICENSE file for details.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GCH_TRACKER_INDEXED_LIST_HPP
+#define GCH_TRACKER_INDEXED_LIST_HPP
+
+#include "common.hpp"
+
+#include <cstddef>
+
+namespace gch
+{
+
+  namespace detail
+  {
+
+    //////////////////
+    // indexed_list //
+    //////////////////
+
+    template <typename T>
+    struct indexed_list_node
+    {
+      template <typename ...Args>
+      explicit
+      indexed_list_node (Args&&... args)
+        noexcept (std::is_nothrow_constructible<T, Args...>::value)
+        : m_value (std::forward<Args> (args)...)
+      { }
+
+      friend
+      bool
+      operator< (const indexed_list_node& lhs, const indexed_list_node& rhs)
+      {
+        return lhs.m_value < rhs.m_value;
+      }
+
+      T                   m_value;
+      mutable std::size_t m_rank = 0;
+    };
+
+    template <typename Storage, typename T>
+    class indexed_list;
+
+    // A list which can report the offset of an element in O(1). Offsets are
+    // computed in a single pass on the first query after a modification, and
+    // are kept up to date by insertions and erasures at the back of the list.
+    // A pass which queries every element without modifying the list is O(n).
+    template <typename Storage, typename T>
+    class indexed_list
+    {
+      using node      = indexed_list_node<T>;
+      using list_type = tracker_container<Storage, node>;
+
+    public:
+      using value_type      = T;
+      using allocator_type  = typename list_type::allocator_type;
+      using size_type       = typename list_type::size_type;
+      using difference_type = typename list_type::difference_type;
+      using reference       = value_type&;
+      using const_reference = const value_type&;
+      using pointer         = value_type *;
+      using const_pointer   = const value_type *;
+
+      using iterator       = node_value_iterator<T, typename list_type::iterator>;
+      using const_iterator = node_value_iterator<T, typename list_type::const_iterator>;
+
+      using reverse_iterator       = std::reverse_iterator<iterator>;
+      using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+      indexed_list            (void)                    = default;
+      indexed_list            (const indexed_list&)     = delete;
+      indexed_list            (indexed_list&&) noexcept = default;
+      indexed_list& operator= (const indexed_list&)     = delete;
+      indexed_list& operator= (indexed_list&&) noexcept = default;
+      ~indexed_list           (void)                    = default;
+
+      explicit
+      indexed_list (const allocator_type& alloc)
+        : m_list (alloc)
+      { }
+
+      void
+      swap (indexed_list& other) noexcept
+      {
+        using std::swap;
+        m_list.swap (other.m_list);
+        swap (m_is_ranked, other.m_is_ranked);
+      }
+
+      GCH_NODISCARD
+      allocator_type
+      get_allocator (void) const noexcept
+      {
+        return m_list.get_allocator ();
+      }
+
+      GCH_NODISCARD iterator       begin  (void)       noexcept { return iterator (m_list.begin ()); }
+      GCH_NODISCARD const_iterator begin  (void) const noexcept { return cbegin (); }
+      GCH_NODISCARD const_iterator cbegin (void) const noexcept { return citer (m_list.cbegin ()); }
+
+      GCH_NODISCARD iterator       end    (void)       noexcept { return iterator (m_list.end ()); }
+      GCH_NODISCARD const_iterator end    (void) const noexcept { return cend (); }
+      GCH_NODISCARD const_iterator cend   (void) const noexcept { return citer (m_list.cend ()); }
+
+      GCH_NODISCARD
+      reverse_iterator
+      rbegin (void) noexcept
+      {
+        return reverse_iterator { end () };
+      }
+
+      GCH_NODISCARD
+      const_reverse_iterator
+      rbegin (void) const noexcept
+      {
+        return crbegin ();
+      }
+
+      GCH_NODISCARD
+      const_reverse_iterator
+      crbegin (void) const noexcept
+      {
+        return const_reverse_iterator { cend () };
+      }
+
+      GCH_NODISCARD
+      reverse_iterator
+      rend (void) noexcept
+      {
+        return reverse_iterator { begin () };
+      }
+
+      GCH_NODISCARD
+      const_reverse_iterator
+      rend (void) const noexcept
+      {
+        return crend ();
+      }
+
+      GCH_NODISCARD
+      const_reverse_iterator
+      crend (void) const noexcept
+      {
+        return const_reverse_iterator { cbegin () };
+      }
+
+      GCH_NODISCARD reference       front (void)       { return m_list.front ().m_value; }
+      GCH_NODISCARD const_reference front (void) const { return m_list.front ().m_value; }
+
+      GCH_NODISCARD reference       back  (void)       { return m_list.back ().m_value;  }
+      GCH_NODISCARD const_reference back  (void) const { return m_list.back ().m_value;  }
+
+      GCH_NODISCARD
+      bool
+      empty (void) const noexcept
+      {
+        return m_list.empty ();
+      }
+
+      GCH_NODISCARD
+      size_type
+      size (void) const noexcept
+      {
+        return m_list.size ();
+      }
+
+      GCH_NODISCARD
+      size_type
+      max_size (void) const noexcept
+      {
+        return m_list.max_size ();
+      }
+
+      GCH_NODISCARD
+      size_type
+      capacity (void) const noexcept
+      {
+        return m_list.capacity ();
+      }
+
+      void
+      reserve (size_type n)
+      {
+        m_list.reserve (n);
+      }
+
+      //! the ranks are relocated along with the elements
+      void
+      shrink_to_fit (void)
+      {
+        m_list.shrink_to_fit ();
+      }
+
+      void
+      trim (void) noexcept
+      {
+        m_list.trim ();
+      }
+
+      GCH_NODISCARD
+      size_type
+      index_of (const const_iterator pos) const noexcept
+      {
+        if (pos == cend ())
+          return size ();
+
+        if (! m_is_ranked)
+        {
+          size_type rank = 0;
+          for (const node& n : m_list)
+            n.m_rank = rank++;
+          m_is_ranked = true;
+        }
+        return pos.base ()->m_rank;
+      }
+
+      template <typename ...Args>
+      iterator
+      emplace (const const_iterator pos, Args&&... args)
+      {
+        const bool at_back = (pos == cend ());
+        const auto it = m_list.emplace (pos.base (), std::forward<Args> (args)...);
+        if (at_back)
+          it->m_rank = size () - 1;
+        else
+          m_is_ranked = false;
+        return iterator (it);
+      }
+
+      template <typename InputIt>
+      iterator
+      insert (const const_iterator pos, InputIt first, const InputIt last)
+      {
+        if (first == last)
+          return iterator (m_list.erase (pos.base (), pos.base ()));
+
+        const iterator ret = emplace (pos, *first);
+        try
+        {
+          while (++first != last)
+            emplace (pos, *first);
+        }
+        catch (...)
+        {
+          erase (ret, pos);
+          throw;
+        }
+        return ret;
+      }
+
+      iterator
+      erase (const const_iterator pos) noexcept
+      {
+        const auto next = m_list.erase (pos.base ());
+        if (next != m_list.end ())
+          m_is_ranked = false;
+        return iterator (next);
+      }
+
+      iterator
+      erase (const const_iterator first, const const_iterator last) noexcept
+      {
+        const auto next = m_list.erase (first.base (), last.base ());
+        if (next != m_list.end ())
+          m_is_ranked = false;
+        return iterator (next);
+      }
+
+      void
+      clear (void) noexcept
+      {
+        m_list.clear ();
+        m_is_ranked = true;
+      }
+
+      void
+      splice (const const_iterator pos, indexed_list& other)
+      {
+        m_list.splice (pos.base (), other.m_list);
+        m_is_ranked = false;
+      }
+
+      void
+      merge (indexed_list& other)
+      {
+        m_list.merge (other.m_list);
+        m_is_ranked = false;
+      }
+
+      void
+      sort (void)
+      {
+        m_list.sort ();
+        m_is_ranked = false;
+      }
+
+      template <typename Pred>
+      void
+      remove_if (Pred pred)
+      {
+        m_list.remove_if ([&pred](const node& n) { return pred (n.m_value); });
+        m_is_ranked = false;
+      }
+
+    private:
+      static
+      const_iterator
+      citer (typename list_type::const_iterator it) noexcept
+      {
+        return const_iterator (it);
+      }
+
+      list_type    m_list;
+      mutable bool m_is_ranked = true;
+    };
+
+  } // namespace gch::detail
+
+  namespace storage
+  {
+
+    // Wraps another storage so that reporter positions can be found in O(1)
+    // (see detail::indexed_list). Costs one extra word per reporter.
+    template <typename Base = list>
+    struct indexed
+    {
+      static_assert (! Base::is_tombstoned::value,
+                     "tombstoned storage must wrap indexed storage, not the reverse");
+      static_assert (! Base::is_compact::value, "compact storage may not be wrapped");
+      static_assert (! Base::is_linked::value, "linked storage may not be wrapped");
+      static_assert (! Base::is_paired::value, "paired storage may not be wrapped");
+      static_assert (! Base::is_sorted::value,
+                     "sorted storage must wrap indexed storage, not the reverse");
+
+      template <typename T>
+      using container_type = detail::indexed_list<Base, T>;
+
+      template <typename T>
+      using iterator_type = detail::node_value_iterator<
+        T, typename Base::template iterator_type<detail::indexed_list_node<T>>>;
+
+      template <typename T>
+      using const_iterator_type = detail::node_value_iterator<
+        T, typename Base::template const_iterator_type<detail::indexed_list_node<T>>>;
+
+      using is_splice_stable = typename Base::is_splice_stable;
+      using is_indexed       = std::true_type;
+      using is_hashed        = std::false_type;
+      using is_tombstoned    = std::false_type;
+      using is_compact       = std::false_type;
+      using is_sorted        = std::false_type;
+      using is_instrumented  = typename Base::is_instrumented;
+      using is_linked        = std::false_type;
+      using is_paired        = std::false_type;
+      using edge_data_type   = typename Base::edge_data_type;
+      using lock_type        = typename Base::lock_type;
+    };
+
+  } // namespace gch::storage
+
+} // namespace gch
+
+#endif // GCH_TRACKER_INDEXED_LIST_HPP
@@ -0,0 +1,639 @@
+/** linked_list.hpp
+ * Copyright © 2021 Gene Harvey
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license. See the LICENSE file for details.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GCH_TRACKER_LINKED_LIST_HPP
+#define GCH_TRACKER_LINKED_LIST_HPP
+
+#include "common.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <memory>
+
+namespace gch
+{
+
+  namespace detail
+  {
+
+    /////////////////
+    // linked_list //
+    /////////////////
+
+    struct linked_node_base
+    {
+      linked_node_base *m_next;
+      linked_node_base *m_prev;
+    };
+
+    // Trivially copyable, so that it may be kept inside of a reporter.
+    template <typename T>
+    struct linked_node
+      : linked_node_base
+    {
+      T m_value;
+    };
+
+    template <typename T, typename Derived>
+    class linked_list_common;
+
+    // Kept outside of linked_list so that the iterator type may be named while
+    // T is still incomplete (T usually holds one of these iterators).
+    template <typename T, bool IsConst>
+    class linked_list_iterator
+    {
+      using node_base = linked_node_base;
+      using node      = linked_node<T>;
+
+    public:
+      using difference_type   = std::ptrdiff_t;
+      using value_type        = T;
+      using pointer           = typename std::conditional<IsConst, const T *, T *>::type;
+      using reference         = typename std::conditional<IsConst, const T&, T&>::type;
+      using iterator_category = std::bidirectional_iterator_tag;
+
+      linked_list_iterator            (void)                            = default;
+      linked_list_iterator            (const linked_list_iterator&)     = default;
+      linked_list_iterator            (linked_list_iterator&&) noexcept = default;
+      linked_list_iterator& operator= (const linked_list_iterator&)     = default;
+      linked_list_iterator& operator= (linked_list_iterator&&) noexcept = default;
+      ~linked_list_iterator           (void)                            = default;
+
+      template <bool C = IsConst, typename std::enable_if<C>::type * = nullptr>
+      /* implicit */
+      linked_list_iterator (const linked_list_iterator<T, false>& other) noexcept
+        : m_node (other.m_node)
+      { }
+
+    private:
+      template <typename, typename>
+      friend class linked_list_common;
+
+      template <typename, bool>
+      friend class linked_list_iterator;
+
+      explicit
+      linked_list_iterator (node_base *n) noexcept
+        : m_node (n)
+      { }
+
+    public:
+      linked_list_iterator&
+      operator++ (void) noexcept
+      {
+        m_node = m_node->m_next;
+        return *this;
+      }
+
+      linked_list_iterator
+      operator++ (int) noexcept
+      {
+        linked_list_iterator ret (*this);
+        ++*this;
+        return ret;
+      }
+
+      linked_list_iterator&
+      operator-- (void) noexcept
+      {
+        m_node = m_node->m_prev;
+        return *this;
+      }
+
+      linked_list_iterator
+      operator-- (int) noexcept
+      {
+        linked_list_iterator ret (*this);
+        --*this;
+        return ret;
+      }
+
+      reference
+      operator* (void) const noexcept
+      {
+        return static_cast<node *> (m_node)->m_value;
+      }
+
+      pointer
+      operator-> (void) const noexcept
+      {
+        return &**this;
+      }
+
+      friend
+      bool
+      operator== (const linked_list_iterator& lhs, const linked_list_iterator& rhs) noexcept
+      {
+        return lhs.m_node == rhs.m_node;
+      }
+
+      friend
+      bool
+      operator!= (const linked_list_iterator& lhs, const linked_list_iterator& rhs) noexcept
+      {
+        return lhs.m_node != rhs.m_node;
+      }
+
+    private:
+      node_base *m_node = nullptr;
+    };
+
+    // The parts of a doubly-linked list which do not depend on who owns the
+    // nodes. `Derived` provides `release (n)`, which is called with each node
+    // after it is erased.
+    template <typename T, typename Derived>
+    class linked_list_common
+    {
+    protected:
+      using node_base = linked_node_base;
+      using node      = linked_node<T>;
+
+    public:
+      using value_type      = T;
+      using size_type       = std::size_t;
+      using difference_type = std::ptrdiff_t;
+      using reference       = value_type&;
+      using const_reference = const value_type&;
+      using pointer         = value_type *;
+      using const_pointer   = const value_type *;
+
+      using iterator               = linked_list_iterator<T, false>;
+      using const_iterator         = linked_list_iterator<T, true>;
+      using reverse_iterator       = std::reverse_iterator<iterator>;
+      using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+      GCH_NODISCARD iterator       begin  (void)       noexcept { return iterator (m_end.m_next); }
+      GCH_NODISCARD const_iterator begin  (void) const noexcept { return cbegin (); }
+      GCH_NODISCARD const_iterator cbegin (void) const noexcept { return citer (m_end.m_next); }
+
+      GCH_NODISCARD iterator       end    (void)       noexcept { return iterator (&m_end); }
+      GCH_NODISCARD const_iterator end    (void) const noexcept { return cend (); }
+      GCH_NODISCARD const_iterator cend   (void) const noexcept { return citer (&m_end); }
+
+      GCH_NODISCARD
+      reverse_iterator
+      rbegin (void) noexcept
+      {
+        return reverse_iterator { end () };
+      }
+
+      GCH_NODISCARD
+      const_reverse_iterator
+      rbegin (void) const noexcept
+      {
+        return crbegin ();
+      }
+
+      GCH_NODISCARD
+      const_reverse_iterator
+      crbegin (void) const noexcept
+      {
+        return const_reverse_iterator { cend () };
+      }
+
+      GCH_NODISCARD
+      reverse_iterator
+      rend (void) noexcept
+      {
+        return reverse_iterator { begin () };
+      }
+
+      GCH_NODISCARD
+      const_reverse_iterator
+      rend (void) const noexcept
+      {
+        return crend ();
+      }
+
+      GCH_NODISCARD
+      const_reverse_iterator
+      crend (void) const noexcept
+      {
+        return const_reverse_iterator { cbegin () };
+      }
+
+      GCH_NODISCARD reference       front (void)       { return *begin ();  }
+      GCH_NODISCARD const_reference front (void) const { return *cbegin (); }
+
+      GCH_NODISCARD reference       back  (void)       { return *--end ();  }
+      GCH_NODISCARD const_reference back  (void) const { return *--cend (); }
+
+      GCH_NODISCARD
+      bool
+      empty (void) const noexcept
+      {
+        return m_size == 0;
+      }
+
+      GCH_NODISCARD
+      size_type
+      size (void) const noexcept
+      {
+        return m_size;
+      }
+
+      GCH_NODISCARD
+      size_type
+      max_size (void) const noexcept
+      {
+        return (std::numeric_limits<size_type>::max) ();
+      }
+
+      iterator
+      erase (const const_iterator pos) noexcept
+      {
+        node_base *next = pos.m_node->m_next;
+        unlink (pos.m_node);
+        static_cast<Derived *> (this)->release (pos.m_node);
+        return iterator { next };
+      }
+
+      iterator
+      erase (const_iterator first, const const_iterator last) noexcept
+      {
+        while (first != last)
+          first = erase (first);
+        return iterator { last.m_node };
+      }
+
+      void
+      splice (const const_iterator pos, Derived& other) noexcept
+      {
+        linked_list_common& src = other;
+        if (&src == this || src.empty ())
+          return;
+
+        node_base *first = src.m_end.m_next;
+        node_base *last  = src.m_end.m_prev;
+        node_base *next  = pos.m_node;
+
+        first->m_prev = next->m_prev;
+        last->m_next  = next;
+        next->m_prev->m_next = first;
+        next->m_prev  = last;
+
+        m_size += src.m_size;
+        src.init ();
+      }
+
+      //! moves [first, last) of `other` in front of `pos`, and returns the first of them
+      iterator
+      splice (const const_iterator pos, Derived& other,
+              const const_iterator first, const const_iterator last) noexcept
+      {
+        if (first == last)
+          return iterator { pos.m_node };
+
+        linked_list_common& src = other;
+        const size_type n = static_cast<size_type> (std::distance (first, last));
+        node_base *head = first.m_node;
+        node_base *tail = last.m_node->m_prev;
+        node_base *next = pos.m_node;
+
+        head->m_prev->m_next = last.m_node;
+        last.m_node->m_prev  = head->m_prev;
+        src.m_size -= n;
+
+        head->m_prev = next->m_prev;
+        tail->m_next = next;
+        next->m_prev->m_next = head;
+        next->m_prev = tail;
+        m_size += n;
+
+        return iterator { head };
+      }
+
+      void
+      merge (Derived& other)
+      {
+        linked_list_common& src = other;
+        if (&src == this)
+          return;
+
+        node_base *curr = m_end.m_next;
+        while (! src.empty ())
+        {
+          node_base *n = src.m_end.m_next;
+          while (curr != &m_end && ! (value_of (n) < value_of (curr)))
+            curr = curr->m_next;
+          src.unlink (n);
+          link (curr, n);
+        }
+      }
+
+      //! a stable merge sort which only relinks the nodes
+      void
+      sort (void)
+      {
+        if (m_size < 2)
+          return;
+
+        node_base *rest = m_end.m_next;
+        node_base *head = sort_chain (rest, m_size);
+
+        node_base *prev = &m_end;
+        for (node_base *n = head; n != nullptr; n = n->m_next)
+        {
+          n->m_prev = prev;
+          prev      = n;
+        }
+        m_end.m_next = head;
+        m_end.m_prev = prev;
+        prev->m_next = &m_end;
+      }
+
+      template <typename Pred>
+      void
+      remove_if (Pred pred)
+      {
+        const_iterator it = cbegin ();
+        while (it != cend ())
+        {
+          if (pred (*it))
+            it = erase (it);
+          else
+            ++it;
+        }
+      }
+
+    protected:
+//    linked_list_common            (void)                          = impl;
+      linked_list_common            (const linked_list_common&)     = delete;
+//    linked_list_common            (linked_list_common&&) noexcept = impl;
+      linked_list_common& operator= (const linked_list_common&)     = delete;
+//    linked_list_common& operator= (linked_list_common&&) noexcept = impl;
+      ~linked_list_common           (void)                          = default;
+
+      linked_list_common (void) noexcept
+      {
+        init ();
+      }
+
+      linked_list_common (linked_list_common&& other) noexcept
+      {
+        steal (other);
+      }
+
+      // the derived list must have released its own nodes first
+      linked_list_common&
+      operator= (linked_list_common&& other) noexcept
+      {
+        if (&other != this)
+          steal (other);
+        return *this;
+      }
+
+      static
+      node_base *
+      node_of (const const_iterator pos) noexcept
+      {
+        return pos.m_node;
+      }
+
+      static
+      iterator
+      iter (node_base *n) noexcept
+      {
+        return iterator { n };
+      }
+
+      static
+      const_iterator
+      citer (const node_base *n) noexcept
+      {
+        return const_iterator { const_cast<node_base *> (n) };
+      }
+
+      static
+      const T&
+      value_of (const node_base *n) noexcept
+      {
+        return static_cast<const node *> (n)->m_value;
+      }
+
+      void
+      init (void) noexcept
+      {
+        m_end.m_next = &m_end;
+        m_end.m_prev = &m_end;
+        m_size       = 0;
+      }
+
+      void
+      link (node_base *pos, node_base *n) noexcept
+      {
+        n->m_next = pos;
+        n->m_prev = pos->m_prev;
+        pos->m_prev->m_next = n;
+        pos->m_prev = n;
+        ++m_size;
+      }
+
+      void
+      unlink (node_base *n) noexcept
+      {
+        n->m_prev->m_next = n->m_next;
+        n->m_next->m_prev = n->m_prev;
+        --m_size;
+      }
+
+    private:
+      // `*this` is left with the nodes of `other`, which is left empty
+      void
+      steal (linked_list_common& other) noexcept
+      {
+        if (other.empty ())
+          return init ();
+
+        m_end  = other.m_end;
+        m_size = other.m_size;
+        m_end.m_next->m_prev = &m_end;
+        m_end.m_prev->m_next = &m_end;
+        other.init ();
+      }
+
+      // Sorts the first `n` nodes of the chain starting at `first`, and returns
+      // them as a null-terminated chain. `first` is advanced past them.
+      static
+      node_base *
+      sort_chain (node_base *& first, size_type n) noexcept
+      {
+        if (n == 1)
+        {
+          node_base *ret = first;
+          first = first->m_next;
+          ret->m_next = nullptr;
+          return ret;
+        }
+
+        node_base *lhs = sort_chain (first, n / 2);
+        node_base *rhs = sort_chain (first, n - n / 2);
+
+        // take from the left on ties, so that the sort is stable
+        node_base  head;
+        node_base *tail = &head;
+        while (lhs != nullptr && rhs != nullptr)
+        {
+          if (value_of (rhs) < value_of (lhs))
+          {
+            tail->m_next = rhs;
+            rhs = rhs->m_next;
+          }
+          else
+          {
+            tail->m_next = lhs;
+            lhs = lhs->m_next;
+          }
+          tail = tail->m_next;
+        }
+        tail->m_next = (lhs != nullptr) ? lhs : rhs;
+        return head.m_next;
+      }
+
+      node_base m_end;
+      size_type m_size;
+    };
+
+    // A doubly-linked list which does not own its nodes. Each element provides
+    // `get_link ()`, which returns the node it is to be kept in, so inserting
+    // and erasing never allocate. The owner of a node which is relocated must
+    // call `relink` with the new node to point its neighbors back at it.
+    //
+    // Since a node may only be in one list at a time, elements may not be
+    // copied from one list into another, so there is no `insert`. They are
+    // moved between lists with `splice` instead.
+    template <typename T>
+    class linked_list
+      : public linked_list_common<T, linked_list<T>>
+    {
+      using base = linked_list_common<T, linked_list<T>>;
+      using node = typename base::node;
+
+      friend base;
+
+    public:
+      using allocator_type = std::allocator<T>;
+      using typename base::size_type;
+      using typename base::iterator;
+      using typename base::const_iterator;
+
+      linked_list            (void)                   = default;
+      linked_list            (const linked_list&)     = delete;
+      linked_list            (linked_list&&) noexcept = default;
+      linked_list& operator= (const linked_list&)     = delete;
+      linked_list& operator= (linked_list&&) noexcept = default;
+      ~linked_list           (void)                   = default;
+
+      explicit
+      linked_list (const allocator_type&) noexcept
+      { }
+
+      void
+      swap (linked_list& other) noexcept
+      {
+        if (&other != this)
+        {
+          linked_list tmp (std::move (other));
+          other = std::move (*this);
+          *this = std::move (tmp);
+        }
+      }
+
+      GCH_NODISCARD
+      allocator_type
+      get_allocator (void) const noexcept
+      {
+        return allocator_type ();
+      }
+
+      //! every element brings its own node, so the list never has to grow
+      GCH_NODISCARD
+      size_type
+      capacity (void) const noexcept
+      {
+        return base::max_size ();
+      }
+
+      void reserve       (size_type) const noexcept { }
+      void shrink_to_fit (void)      const noexcept { }
+      void trim          (void)      const noexcept { }
+
+      //! links the node of the new element in front of `pos`
+      template <typename ...Args>
+      iterator
+      emplace (const const_iterator pos, Args&&... args)
+        noexcept (std::is_nothrow_constructible<T, Args...>::value)
+      {
+        T value (std::forward<Args> (args)...);
+        node& n = value.get_link ();
+        n.m_value = value;
+        base::link (base::node_of (pos), &n);
+        return base::iter (&n);
+      }
+
+      //! the nodes are left to their owners
+      void
+      clear (void) noexcept
+      {
+        base::init ();
+      }
+
+      //! points the neighbors of `n`, which has just been relocated, back at it
+      iterator
+      relink (node& n) noexcept
+      {
+        n.m_prev->m_next = &n;
+        n.m_next->m_prev = &n;
+        return base::iter (&n);
+      }
+
+    private:
+      static
+      void
+      release (linked_node_base *) noexcept
+      { }
+    };
+
+  } // namespace gch::detail
+
+  namespace storage
+  {
+
+    // Keeps the node of each reporter inside of the reporter itself, so that
+    // binding, rebinding, and debinding never allocate. A reporter which is
+    // moved relinks its node. Only for trackers of reporters, and it may not be
+    // wrapped by the storage which keeps an index of the reporters.
+    struct linked
+    {
+      template <typename T>
+      using container_type = detail::linked_list<T>;
+
+      template <typename T>
+      using iterator_type = detail::linked_list_iterator<T, false>;
+
+      template <typename T>
+      using const_iterator_type = detail::linked_list_iterator<T, true>;
+
+      using is_splice_stable = std::true_type;
+      using is_indexed       = std::false_type;
+      using is_hashed        = std::false_type;
+      using is_tombstoned    = std::false_type;
+      using is_compact       = std::false_type;
+      using is_sorted        = std::false_type;
+      using is_instrumented  = std::false_type;
+      using is_linked        = std::true_type;
+      using is_paired        = std::false_type;
+      using edge_data_type   = void;
+      using lock_type        = void;
+    };
+
+  } // namespace gch::storage
+
+} // namespace gch
+
+#endif // GCH_TRACKER_LINKED_LIST_HPP
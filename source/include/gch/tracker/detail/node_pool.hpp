@@ -0,0 +1,419 @@
+/** node_pool.hpp
+ * Copyright © 2021 Gene Harvey
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license. See the LICENSE file for details.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GCH_TRACKER_NODE_POOL_HPP
+#define GCH_TRACKER_NODE_POOL_HPP
+
+#include "common.hpp"
+#include "concurrent.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace gch
+{
+
+  namespace pool_scope
+  {
+
+    // One pool per type for the whole program. Guarded by a spinlock.
+    struct global;
+
+    // One pool per type for each thread. Blocks may be freed on another thread
+    // than the one they came from, in which case they go to that thread's pool
+    // (and `num_in_use` is only meaningful when summed over the threads).
+    struct thread;
+
+  } // namespace gch::pool_scope
+
+  struct pool_stats
+  {
+    std::size_t num_in_use   = 0; //!< blocks currently held by containers
+    std::size_t num_cached   = 0; //!< freed blocks waiting to be reused
+    std::size_t bytes_cached = 0;
+    std::size_t num_reused   = 0; //!< allocations served from the cache
+    std::size_t num_fresh    = 0; //!< allocations served by operator new
+  };
+
+  namespace detail
+  {
+
+    class node_pool_base
+    {
+    public:
+      virtual pool_stats get_stats (void) const noexcept = 0;
+      virtual void       trim      (void)       noexcept = 0;
+
+    protected:
+      node_pool_base            (void)                      = default;
+      node_pool_base            (const node_pool_base&)     = delete;
+      node_pool_base            (node_pool_base&&) noexcept = delete;
+      node_pool_base& operator= (const node_pool_base&)     = delete;
+      node_pool_base& operator= (node_pool_base&&) noexcept = delete;
+      ~node_pool_base           (void)                      = default;
+    };
+
+    // The pools of a scope, so that they may be inspected and trimmed together.
+    template <typename Scope>
+    class node_pool_registry
+    {
+    public:
+      static
+      node_pool_registry&
+      get (void)
+      {
+        return get (static_cast<Scope *> (nullptr));
+      }
+
+      void
+      add (node_pool_base& p)
+      {
+        const std::lock_guard<shared_spinlock> guard (m_lock);
+        m_pools.push_back (&p);
+      }
+
+      void
+      remove (node_pool_base& p) noexcept
+      {
+        const std::lock_guard<shared_spinlock> guard (m_lock);
+        m_pools.erase (std::find (m_pools.begin (), m_pools.end (), &p));
+      }
+
+      GCH_NODISCARD
+      pool_stats
+      get_stats (void) const noexcept
+      {
+        const std::lock_guard<shared_spinlock> guard (m_lock);
+        pool_stats ret;
+        for (const node_pool_base *p : m_pools)
+        {
+          const pool_stats s = p->get_stats ();
+          ret.num_in_use   += s.num_in_use;
+          ret.num_cached   += s.num_cached;
+          ret.bytes_cached += s.bytes_cached;
+          ret.num_reused   += s.num_reused;
+          ret.num_fresh    += s.num_fresh;
+        }
+        return ret;
+      }
+
+      void
+      trim (void) noexcept
+      {
+        const std::lock_guard<shared_spinlock> guard (m_lock);
+        for (node_pool_base *p : m_pools)
+          p->trim ();
+      }
+
+    private:
+      // never destroyed, so that objects with static storage duration may
+      // still free their blocks during exit
+      static
+      node_pool_registry&
+      get (pool_scope::global *)
+      {
+        static node_pool_registry *r = new node_pool_registry;
+        return *r;
+      }
+
+      static
+      node_pool_registry&
+      get (pool_scope::thread *)
+      {
+        static thread_local node_pool_registry r;
+        return r;
+      }
+
+      mutable shared_spinlock      m_lock;
+      std::vector<node_pool_base *> m_pools;
+    };
+
+    ///////////////
+    // node_pool //
+    ///////////////
+
+    // Caches freed blocks of T by their length, and hands them back out to the
+    // next container which asks for a block of the same length. plf::list asks
+    // for a handful of lengths (its group sizes), so the buckets are searched
+    // linearly.
+    template <typename T, typename Scope>
+    class node_pool
+      : public node_pool_base
+    {
+      static_assert (alignof (T) <= alignof (std::max_align_t),
+                     "over-aligned types may not be pooled");
+
+      struct free_block
+      {
+        free_block *m_next;
+      };
+
+      struct bucket
+      {
+        std::size_t m_length;
+        free_block *m_head;
+        std::size_t m_num_cached;
+      };
+
+    public:
+//    node_pool            (void)                 = impl;
+      node_pool            (const node_pool&)     = delete;
+      node_pool            (node_pool&&) noexcept = delete;
+      node_pool& operator= (const node_pool&)     = delete;
+      node_pool& operator= (node_pool&&) noexcept = delete;
+//    ~node_pool           (void)                 = impl;
+
+      ~node_pool (void)
+      {
+        node_pool_registry<Scope>::get ().remove (*this);
+        trim ();
+      }
+
+      static
+      node_pool&
+      get (void)
+      {
+        return get (static_cast<Scope *> (nullptr));
+      }
+
+      GCH_NODISCARD
+      T *
+      allocate (std::size_t n)
+      {
+        {
+          const std::lock_guard<shared_spinlock> guard (m_lock);
+          ++m_stats.num_in_use;
+          bucket& b = find_bucket (n);
+          if (b.m_head != nullptr)
+          {
+            free_block *ret = b.m_head;
+            b.m_head = ret->m_next;
+            --b.m_num_cached;
+            --m_stats.num_cached;
+            m_stats.bytes_cached -= block_size (n);
+            ++m_stats.num_reused;
+            return reinterpret_cast<T *> (ret);
+          }
+          ++m_stats.num_fresh;
+        }
+
+        try
+        {
+          return static_cast<T *> (::operator new (block_size (n)));
+        }
+        catch (...)
+        {
+          const std::lock_guard<shared_spinlock> guard (m_lock);
+          --m_stats.num_in_use;
+          --m_stats.num_fresh;
+          throw;
+        }
+      }
+
+      void
+      deallocate (T *p, std::size_t n) noexcept
+      {
+        const std::lock_guard<shared_spinlock> guard (m_lock);
+        --m_stats.num_in_use;
+        bucket *b = find_existing_bucket (n);
+        if (b == nullptr)
+        {
+          // a block from another thread's pool, with a length this one hasn't seen
+          try
+          {
+            b = &find_bucket (n);
+          }
+          catch (...)
+          {
+            ::operator delete (p);
+            return;
+          }
+        }
+        free_block *blk = ::new (static_cast<void *> (p)) free_block { b->m_head };
+        b->m_head = blk;
+        ++b->m_num_cached;
+        ++m_stats.num_cached;
+        m_stats.bytes_cached += block_size (n);
+      }
+
+      GCH_NODISCARD
+      pool_stats
+      get_stats (void) const noexcept override
+      {
+        const std::lock_guard<shared_spinlock> guard (m_lock);
+        return m_stats;
+      }
+
+      //! frees the cached blocks
+      void
+      trim (void) noexcept override
+      {
+        const std::lock_guard<shared_spinlock> guard (m_lock);
+        for (bucket& b : m_buckets)
+        {
+          while (b.m_head != nullptr)
+          {
+            free_block *next = b.m_head->m_next;
+            ::operator delete (b.m_head);
+            b.m_head = next;
+          }
+          b.m_num_cached = 0;
+        }
+        m_stats.num_cached   = 0;
+        m_stats.bytes_cached = 0;
+      }
+
+    private:
+      node_pool (void)
+      {
+        node_pool_registry<Scope>::get ().add (*this);
+      }
+
+      // never destroyed; see node_pool_registry
+      static
+      node_pool&
+      get (pool_scope::global *)
+      {
+        static node_pool *p = new node_pool;
+        return *p;
+      }
+
+      static
+      node_pool&
+      get (pool_scope::thread *)
+      {
+        static thread_local node_pool p;
+        return p;
+      }
+
+      static constexpr
+      std::size_t
+      block_size (std::size_t n) noexcept
+      {
+        return (std::max) (n * sizeof (T), sizeof (free_block));
+      }
+
+      bucket *
+      find_existing_bucket (std::size_t n) noexcept
+      {
+        for (bucket& b : m_buckets)
+        {
+          if (b.m_length == n)
+            return &b;
+        }
+        return nullptr;
+      }
+
+      bucket&
+      find_bucket (std::size_t n)
+      {
+        if (bucket *b = find_existing_bucket (n))
+          return *b;
+        m_buckets.push_back ({ n, nullptr, 0 });
+        return m_buckets.back ();
+      }
+
+      mutable shared_spinlock m_lock;
+      std::vector<bucket>     m_buckets;
+      pool_stats              m_stats;
+    };
+
+  } // namespace gch::detail
+
+  ////////////////////
+  // pool_allocator //
+  ////////////////////
+
+  // An allocator which draws from the pool shared by every container with the
+  // same value type. Since all instances draw from the same pool, they always
+  // compare equal, so trackers using it may still splice between each other.
+  template <typename T, typename Scope = pool_scope::global>
+  class pool_allocator
+  {
+  public:
+    using value_type = T;
+
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap            = std::true_type;
+    using is_always_equal                        = std::true_type;
+
+    pool_allocator            (void)                      = default;
+    pool_allocator            (const pool_allocator&)     = default;
+    pool_allocator            (pool_allocator&&) noexcept = default;
+    pool_allocator& operator= (const pool_allocator&)     = default;
+    pool_allocator& operator= (pool_allocator&&) noexcept = default;
+    ~pool_allocator           (void)                      = default;
+
+    template <typename U>
+    constexpr
+    pool_allocator (const pool_allocator<U, Scope>&) noexcept
+    { }
+
+    GCH_NODISCARD
+    T *
+    allocate (std::size_t n)
+    {
+      return detail::node_pool<T, Scope>::get ().allocate (n);
+    }
+
+    void
+    deallocate (T *p, std::size_t n) noexcept
+    {
+      detail::node_pool<T, Scope>::get ().deallocate (p, n);
+    }
+  };
+
+  template <typename T, typename U, typename Scope>
+  constexpr
+  bool
+  operator== (const pool_allocator<T, Scope>&, const pool_allocator<U, Scope>&) noexcept
+  {
+    return true;
+  }
+
+  template <typename T, typename U, typename Scope>
+  constexpr
+  bool
+  operator!= (const pool_allocator<T, Scope>&, const pool_allocator<U, Scope>&) noexcept
+  {
+    return false;
+  }
+
+  //! statistics summed over the pools of `Scope` (of this thread, for pool_scope::thread)
+  template <typename Scope = pool_scope::global>
+  GCH_NODISCARD
+  pool_stats
+  get_pool_stats (void) noexcept
+  {
+    return detail::node_pool_registry<Scope>::get ().get_stats ();
+  }
+
+  //! frees the blocks cached by the pools of `Scope`
+  template <typename Scope = pool_scope::global>
+  void
+  trim_pools (void) noexcept
+  {
+    detail::node_pool_registry<Scope>::get ().trim ();
+  }
+
+  namespace storage
+  {
+
+    // plf::list storage whose nodes come from pools shared by every tracker
+    // with the same reporter type (see gch::pool_allocator).
+    template <typename Scope = pool_scope::global>
+    using pooled = basic_list<plf::list, pool_allocator<void, Scope>>;
+
+  } // namespace gch::storage
+
+} // namespace gch
+
+#endif // GCH_TRACKER_NODE_POOL_HPP
@@ -0,0 +1,227 @@
+/** paired_list.hpp
+ * Copyright © 2021 Gene Harvey
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license. See the LICENSE file for details.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GCH_TRACKER_PAIRED_LIST_HPP
+#define GCH_TRACKER_PAIRED_LIST_HPP
+
+#include "common.hpp"
+#include "linked_list.hpp"
+#include "node_pool.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace gch
+{
+
+  namespace detail
+  {
+
+    /////////////////
+    // paired_list //
+    /////////////////
+
+    template <typename T>
+    struct paired_edge;
+
+    template <typename T>
+    struct paired_node
+      : linked_node<T>
+    {
+      paired_edge<T> *m_edge;
+    };
+
+    // Both ends of a binding, which are freed once both have been erased.
+    template <typename T>
+    struct paired_edge
+    {
+      paired_edge (void) noexcept
+        : m_num_live (2)
+      {
+        m_halves[0].m_edge = this;
+        m_halves[1].m_edge = this;
+      }
+
+      paired_node<T>             m_halves[2];
+      std::atomic<unsigned char> m_num_live;
+    };
+
+    // A doubly-linked list whose nodes are allocated two at a time, one for
+    // each of the lists on the ends of a binding (see `emplace_pair`). A node
+    // may be erased from either list, and the pair is freed along with the
+    // second of them, so the allocator must be stateless.
+    template <typename T, typename Allocator = std::allocator<T>>
+    class paired_list
+      : public linked_list_common<T, paired_list<T, Allocator>>
+    {
+      using base = linked_list_common<T, paired_list<T, Allocator>>;
+      using node = paired_node<T>;
+      using edge = paired_edge<T>;
+
+      using edge_allocator    = typename std::allocator_traits<Allocator>::template
+                                  rebind_alloc<edge>;
+      using edge_alloc_traits = std::allocator_traits<edge_allocator>;
+
+      static_assert (std::is_empty<Allocator>::value,
+                     "paired_list requires a stateless allocator");
+
+      friend base;
+
+    public:
+      using allocator_type = Allocator;
+      using typename base::size_type;
+      using typename base::iterator;
+      using typename base::const_iterator;
+
+      paired_list            (void)                   = default;
+      paired_list            (const paired_list&)     = delete;
+      paired_list            (paired_list&&) noexcept = default;
+      paired_list& operator= (const paired_list&)     = delete;
+//    paired_list& operator= (paired_list&&) noexcept = impl;
+//    ~paired_list           (void)                   = impl;
+
+      explicit
+      paired_list (const allocator_type&) noexcept
+      { }
+
+      paired_list&
+      operator= (paired_list&& other) noexcept
+      {
+        if (&other != this)
+        {
+          clear ();
+          base::operator= (std::move (other));
+        }
+        return *this;
+      }
+
+      ~paired_list (void)
+      {
+        clear ();
+      }
+
+      void
+      swap (paired_list& other) noexcept
+      {
+        if (&other != this)
+        {
+          paired_list tmp (std::move (other));
+          other = std::move (*this);
+          *this = std::move (tmp);
+        }
+      }
+
+      GCH_NODISCARD
+      allocator_type
+      get_allocator (void) const noexcept
+      {
+        return allocator_type ();
+      }
+
+      //! every new element is the first half of a new pair
+      GCH_NODISCARD
+      size_type
+      capacity (void) const noexcept
+      {
+        return base::size ();
+      }
+
+      void reserve       (size_type) const noexcept { }
+      void shrink_to_fit (void)      const noexcept { }
+      void trim          (void)      const noexcept { }
+
+      //! Links `value` in front of `pos`, and `other_value` in front of `other_pos`
+      //! in `other`, with a single allocation. Returns the positions of both.
+      std::pair<iterator, iterator>
+      emplace_pair (const const_iterator pos, const T& value,
+                    paired_list& other, const const_iterator other_pos, const T& other_value)
+      {
+        edge_allocator alloc;
+        edge *e = edge_alloc_traits::allocate (alloc, 1);
+        ::new (static_cast<void *> (e)) edge;
+
+        e->m_halves[0].m_value = value;
+        e->m_halves[1].m_value = other_value;
+        base::link (base::node_of (pos), &e->m_halves[0]);
+        other.link (base::node_of (other_pos), &e->m_halves[1]);
+        return { base::iter (&e->m_halves[0]), base::iter (&e->m_halves[1]) };
+      }
+
+      void
+      clear (void) noexcept
+      {
+        linked_node_base *n = base::node_of (base::cbegin ());
+        while (n != base::node_of (base::cend ()))
+        {
+          linked_node_base *next = n->m_next;
+          release (n);
+          n = next;
+        }
+        base::init ();
+      }
+
+    private:
+      // the two halves may be erased by different trackers at once
+      static
+      void
+      release (linked_node_base *n) noexcept
+      {
+        edge *e = static_cast<node *> (n)->m_edge;
+        if (e->m_num_live.fetch_sub (1, std::memory_order_acq_rel) == 1)
+        {
+          edge_allocator alloc;
+          e->~edge ();
+          edge_alloc_traits::deallocate (alloc, e, 1);
+        }
+      }
+    };
+
+  } // namespace gch::detail
+
+  namespace storage
+  {
+
+    // Allocates both ends of a binding between two trackers at once, from the
+    // pool shared by every tracker with the same reporter type by default (see
+    // gch::pool_allocator). Binding, rebinding, and debinding then allocate and
+    // free once per binding rather than once per end. Only for trackers of
+    // trackers with the same storage, and it may not be wrapped by the storage
+    // which keeps an index of the reporters.
+    template <typename Allocator = pool_allocator<void>>
+    struct paired
+    {
+      template <typename T>
+      using container_type = detail::paired_list<
+        T, typename std::allocator_traits<Allocator>::template rebind_alloc<T>>;
+
+      template <typename T>
+      using iterator_type = detail::linked_list_iterator<T, false>;
+
+      template <typename T>
+      using const_iterator_type = detail::linked_list_iterator<T, true>;
+
+      using is_splice_stable = std::true_type;
+      using is_indexed       = std::false_type;
+      using is_hashed        = std::false_type;
+      using is_tombstoned    = std::false_type;
+      using is_compact       = std::false_type;
+      using is_sorted        = std::false_type;
+      using is_instrumented  = std::false_type;
+      using is_linked        = std::false_type;
+      using is_paired        = std::true_type;
+      using edge_data_type   = void;
+      using lock_type        = void;
+    };
+
+  } // namespace gch::storage
+
+} // namespace gch
+
+#endif // GCH_TRACKER_PAIRED_LIST_HPP
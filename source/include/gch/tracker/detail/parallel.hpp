@@ -0,0 +1,187 @@
+/** parallel.hpp
+ * Copyright © 2021 Gene Harvey
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license. See the LICENSE file for details.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GCH_TRACKER_PARALLEL_HPP
+#define GCH_TRACKER_PARALLEL_HPP
+
+#include "common.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+namespace gch
+{
+
+  namespace detail
+  {
+
+    /////////////////////
+    // parallel_chunks //
+    /////////////////////
+
+    // The runs of a range which are shared by the tasks of `parallel_for_each_chunk`.
+    // Each task claims the next unvisited run until there are none left, so that a
+    // task which is slow to start, or a run which is slow to visit, does not hold
+    // up the others.
+    template <typename Iterator, typename Visitor>
+    class parallel_chunks
+    {
+    public:
+      parallel_chunks            (void)                       = delete;
+      parallel_chunks            (const parallel_chunks&)     = delete;
+      parallel_chunks            (parallel_chunks&&) noexcept = delete;
+      parallel_chunks& operator= (const parallel_chunks&)     = delete;
+      parallel_chunks& operator= (parallel_chunks&&) noexcept = delete;
+      ~parallel_chunks           (void)                       = default;
+
+      parallel_chunks (std::vector<Iterator>&& bounds, Visitor& visit) noexcept
+        : m_bounds (std::move (bounds)),
+          m_visit  (visit)
+      { }
+
+      //! visits runs until there are none left, or until one has thrown
+      void
+      run (void) noexcept
+      {
+        const std::size_t num_chunks = m_bounds.size () - 1;
+        while (! m_has_error.load (std::memory_order_relaxed))
+        {
+          const std::size_t i = m_next.fetch_add (1, std::memory_order_relaxed);
+          if (num_chunks <= i)
+            return;
+
+          try
+          {
+            m_visit (m_bounds[i], m_bounds[i + 1]);
+          }
+          catch (...)
+          {
+            set_error (std::current_exception ());
+          }
+        }
+      }
+
+      void
+      set_error (std::exception_ptr e) noexcept
+      {
+        if (! m_has_error.exchange (true, std::memory_order_relaxed))
+          m_error = std::move (e);
+      }
+
+      void
+      add_task (void) noexcept
+      {
+        m_num_tasks.fetch_add (1, std::memory_order_relaxed);
+      }
+
+      //! must be the last use of *this by a task
+      void
+      finish_task (void) noexcept
+      {
+        m_num_tasks.fetch_sub (1, std::memory_order_release);
+      }
+
+      //! waits for every task to finish, then rethrows the first exception of any of them
+      void
+      join (void)
+      {
+        while (m_num_tasks.load (std::memory_order_acquire) != 0)
+          std::this_thread::yield ();
+
+        if (m_error)
+          std::rethrow_exception (m_error);
+      }
+
+    private:
+      const std::vector<Iterator> m_bounds;
+      Visitor&                    m_visit;
+      std::atomic<std::size_t>    m_next      { 0 };
+      std::atomic<std::size_t>    m_num_tasks { 0 };
+      std::atomic<bool>           m_has_error { false };
+      std::exception_ptr          m_error;
+    };
+
+    template <typename Chunks>
+    struct parallel_task
+    {
+      void
+      operator() (void) const noexcept
+      {
+        m_chunks->run ();
+        m_chunks->finish_task ();
+      }
+
+      Chunks *m_chunks;
+    };
+
+    //! Calls `visit (first, last)` on contiguous runs which together cover [first, last),
+    //! from the calling thread and from up to `num_tasks - 1` tasks handed to `executor`,
+    //! which may be any callable which runs a `void ()` task, on another thread or not.
+    //! `size` is about the length of the range. If `executor` throws, no more tasks are
+    //! handed to it. Returns once every task has finished, and rethrows the first
+    //! exception thrown by `visit`.
+    template <typename Iterator, typename Executor, typename Visitor>
+    void
+    parallel_for_each_chunk (const Iterator first, const Iterator last, const std::size_t size,
+                             const std::size_t num_tasks, Executor& executor, Visitor visit)
+    {
+      // a few runs for each task, so that they stay busy if the runs are uneven
+      constexpr std::size_t chunks_per_task = 4;
+
+      const std::size_t num_chunks = (std::min) (size, num_tasks * chunks_per_task);
+      if (num_tasks <= 1 || num_chunks <= 1)
+      {
+        visit (first, last);
+        return;
+      }
+
+      // the bounds are found by walking the range once, which is still far cheaper
+      // than copying it out
+      std::vector<Iterator> bounds;
+      bounds.reserve (num_chunks + 1);
+      bounds.push_back (first);
+
+      Iterator it = first;
+      for (std::size_t i = 0; i < num_chunks - 1; ++i)
+      {
+        std::advance (it, static_cast<typename std::iterator_traits<Iterator>::difference_type> (
+                            size / num_chunks + (i < size % num_chunks ? 1 : 0)));
+        bounds.push_back (it);
+      }
+      bounds.push_back (last);
+
+      using chunks_type = parallel_chunks<Iterator, Visitor>;
+      chunks_type chunks (std::move (bounds), visit);
+      for (std::size_t i = 1; i < num_tasks; ++i)
+      {
+        chunks.add_task ();
+        try
+        {
+          executor (parallel_task<chunks_type> { &chunks });
+        }
+        catch (...)
+        {
+          // the calling thread picks up the runs which this task would have visited
+          chunks.finish_task ();
+          break;
+        }
+      }
+
+      chunks.run ();
+      chunks.join ();
+    }
+
+  } // namespace gch::detail
+
+} // namespace gch
+
+#endif // GCH_TRACKER_PARALLEL_HPP
@@ -0,0 +1,746 @@
+/** slot_list.hpp
+ * Copyright © 2021 Gene Harvey
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license. See the LICENSE file for details.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GCH_TRACKER_SLOT_LIST_HPP
+#define GCH_TRACKER_SLOT_LIST_HPP
+
+#include "common.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+namespace gch
+{
+
+  namespace detail
+  {
+
+    ///////////////
+    // slot_list //
+    ///////////////
+
+    template <typename T>
+    struct slot_list_slot
+    {
+      std::uint32_t m_next;
+      std::uint32_t m_prev;
+      std::uint32_t m_generation;
+      typename std::aligned_storage<sizeof (T), alignof (T)>::type m_storage;
+    };
+
+    template <typename T, typename Allocator>
+    class slot_list;
+
+    // Holds the list and a slot index, since the slots move when the list grows.
+    // Kept outside of slot_list so that the iterator type may be named while T
+    // is still incomplete.
+    template <typename T, typename Allocator, bool IsConst>
+    class slot_list_iterator
+    {
+      using list_type = slot_list<T, Allocator>;
+
+    public:
+      using difference_type   = std::ptrdiff_t;
+      using value_type        = T;
+      using pointer           = typename std::conditional<IsConst, const T *, T *>::type;
+      using reference         = typename std::conditional<IsConst, const T&, T&>::type;
+      using iterator_category = std::bidirectional_iterator_tag;
+
+      slot_list_iterator            (void)                          = default;
+      slot_list_iterator            (const slot_list_iterator&)     = default;
+      slot_list_iterator            (slot_list_iterator&&) noexcept = default;
+      slot_list_iterator& operator= (const slot_list_iterator&)     = default;
+      slot_list_iterator& operator= (slot_list_iterator&&) noexcept = default;
+      ~slot_list_iterator           (void)                          = default;
+
+      template <bool C = IsConst, typename std::enable_if<C>::type * = nullptr>
+      /* implicit */
+      slot_list_iterator (const slot_list_iterator<T, Allocator, false>& other) noexcept
+        : m_list  (other.m_list),
+          m_index (other.m_index)
+      { }
+
+    private:
+      template <typename, typename>
+      friend class slot_list;
+
+      template <typename, typename, bool>
+      friend class slot_list_iterator;
+
+      slot_list_iterator (const list_type *l, std::uint32_t index) noexcept
+        : m_list  (l),
+          m_index (index)
+      { }
+
+    public:
+      slot_list_iterator&
+      operator++ (void) noexcept
+      {
+        m_index = m_list->slot_at (m_index).m_next;
+        return *this;
+      }
+
+      slot_list_iterator
+      operator++ (int) noexcept
+      {
+        slot_list_iterator ret (*this);
+        ++*this;
+        return ret;
+      }
+
+      slot_list_iterator&
+      operator-- (void) noexcept
+      {
+        m_index = m_list->slot_at (m_index).m_prev;
+        return *this;
+      }
+
+      slot_list_iterator
+      operator-- (int) noexcept
+      {
+        slot_list_iterator ret (*this);
+        --*this;
+        return ret;
+      }
+
+      reference
+      operator* (void) const noexcept
+      {
+        return const_cast<reference> (m_list->value_at (m_index));
+      }
+
+      pointer
+      operator-> (void) const noexcept
+      {
+        return &**this;
+      }
+
+      friend
+      bool
+      operator== (const slot_list_iterator& lhs, const slot_list_iterator& rhs) noexcept
+      {
+        return lhs.m_index == rhs.m_index;
+      }
+
+      friend
+      bool
+      operator!= (const slot_list_iterator& lhs, const slot_list_iterator& rhs) noexcept
+      {
+        return lhs.m_index != rhs.m_index;
+      }
+
+    private:
+      const list_type *m_list  = nullptr;
+      std::uint32_t    m_index = 0;
+    };
+
+    // A doubly-linked list whose elements live in one array of slots, linked by
+    // 32-bit indices. The index of an element (its handle) is kept for as long
+    // as the element is in the list, and survives moving and swapping the list,
+    // but not splicing it. Slot 0 is the end of the list. Erased slots are
+    // reused before the array grows. Elements are relocated bytewise when the
+    // array grows, so T must be trivially copyable.
+    //
+    // Each slot also has a generation, drawn from a counter of the list every
+    // time the slot is taken or freed, so that a handle paired with the
+    // generation of its slot can be checked for staleness in O(1).
+    template <typename T, typename Allocator = std::allocator<T>>
+    class slot_list
+    {
+      using slot             = slot_list_slot<T>;
+      using slot_allocator   = typename std::allocator_traits<Allocator>::template
+                                 rebind_alloc<slot>;
+      using slot_vector      = std::vector<slot, slot_allocator>;
+
+      static constexpr std::uint32_t end_index = 0;
+
+    public:
+      using value_type      = T;
+      using allocator_type  = Allocator;
+      using size_type       = std::size_t;
+      using difference_type = std::ptrdiff_t;
+      using reference       = value_type&;
+      using const_reference = const value_type&;
+      using pointer         = value_type *;
+      using const_pointer   = const value_type *;
+      using handle_type     = std::uint32_t;
+
+      using iterator               = slot_list_iterator<T, Allocator, false>;
+      using const_iterator         = slot_list_iterator<T, Allocator, true>;
+      using reverse_iterator       = std::reverse_iterator<iterator>;
+      using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+      template <typename, typename, bool>
+      friend class slot_list_iterator;
+
+//    slot_list            (void)                 = impl;
+      slot_list            (const slot_list&)     = delete;
+//    slot_list            (slot_list&&) noexcept = impl;
+      slot_list& operator= (const slot_list&)     = delete;
+//    slot_list& operator= (slot_list&&) noexcept = impl;
+      ~slot_list           (void)                 = default;
+
+      slot_list (void)
+        : slot_list (allocator_type ())
+      { }
+
+      explicit
+      slot_list (const allocator_type& alloc)
+        : m_slots (slot_allocator (alloc))
+      {
+        init ();
+      }
+
+      // the moved-from list has no slots, and is set up again on first use
+      slot_list (slot_list&& other) noexcept
+        : m_slots      (std::move (other.m_slots)),
+          m_free       (other.m_free),
+          m_size       (other.m_size),
+          m_generation (other.m_generation)
+      {
+        other.m_free = end_index;
+        other.m_size = 0;
+      }
+
+      slot_list&
+      operator= (slot_list&& other) noexcept
+      {
+        if (&other != this)
+        {
+          m_slots      = std::move (other.m_slots);
+          m_free       = other.m_free;
+          m_size       = other.m_size;
+          m_generation = (std::max) (m_generation, other.m_generation);
+          other.m_slots.clear ();
+          other.m_free = end_index;
+          other.m_size = 0;
+        }
+        return *this;
+      }
+
+      void
+      swap (slot_list& other) noexcept
+      {
+        using std::swap;
+        m_slots.swap (other.m_slots);
+        swap (m_free, other.m_free);
+        swap (m_size, other.m_size);
+        swap (m_generation, other.m_generation);
+      }
+
+      GCH_NODISCARD
+      allocator_type
+      get_allocator (void) const noexcept
+      {
+        return allocator_type (m_slots.get_allocator ());
+      }
+
+      GCH_NODISCARD iterator       begin  (void)       noexcept { return iter (first_index ()); }
+      GCH_NODISCARD const_iterator begin  (void) const noexcept { return cbegin (); }
+      GCH_NODISCARD const_iterator cbegin (void) const noexcept { return citer (first_index ()); }
+
+      GCH_NODISCARD iterator       end    (void)       noexcept { return iter (end_index); }
+      GCH_NODISCARD const_iterator end    (void) const noexcept { return cend (); }
+      GCH_NODISCARD const_iterator cend   (void) const noexcept { return citer (end_index); }
+
+      GCH_NODISCARD
+      reverse_iterator
+      rbegin (void) noexcept
+      {
+        return reverse_iterator { end () };
+      }
+
+      GCH_NODISCARD
+      const_reverse_iterator
+      rbegin (void) const noexcept
+      {
+        return crbegin ();
+      }
+
+      GCH_NODISCARD
+      const_reverse_iterator
+      crbegin (void) const noexcept
+      {
+        return const_reverse_iterator { cend () };
+      }
+
+      GCH_NODISCARD
+      reverse_iterator
+      rend (void) noexcept
+      {
+        return reverse_iterator { begin () };
+      }
+
+      GCH_NODISCARD
+      const_reverse_iterator
+      rend (void) const noexcept
+      {
+        return crend ();
+      }
+
+      GCH_NODISCARD
+      const_reverse_iterator
+      crend (void) const noexcept
+      {
+        return const_reverse_iterator { cbegin () };
+      }
+
+      GCH_NODISCARD reference       front (void)       { return *begin ();  }
+      GCH_NODISCARD const_reference front (void) const { return *cbegin (); }
+
+      GCH_NODISCARD reference       back  (void)       { return *--end ();  }
+      GCH_NODISCARD const_reference back  (void) const { return *--cend (); }
+
+      GCH_NODISCARD
+      bool
+      empty (void) const noexcept
+      {
+        return m_size == 0;
+      }
+
+      GCH_NODISCARD
+      size_type
+      size (void) const noexcept
+      {
+        return m_size;
+      }
+
+      GCH_NODISCARD
+      size_type
+      max_size (void) const noexcept
+      {
+        return (std::min) (m_slots.max_size () - 1,
+                           size_type ((std::numeric_limits<std::uint32_t>::max) ()));
+      }
+
+      GCH_NODISCARD
+      size_type
+      capacity (void) const noexcept
+      {
+        return m_slots.capacity () == 0 ? 0 : m_slots.capacity () - 1;
+      }
+
+      void
+      reserve (size_type n)
+      {
+        if (max_size () < n)
+          throw std::length_error ("slot_list ran out of slots");
+        m_slots.reserve (n + 1);
+      }
+
+      // Handles are kept, so freed slots in the middle of the array stay where
+      // they are. Only the spare room at the end is given back, or everything if
+      // the list is empty.
+      void
+      shrink_to_fit (void)
+      {
+        if (empty ())
+          free_slots ();
+        else
+          m_slots.shrink_to_fit ();
+      }
+
+      void
+      trim (void) noexcept
+      {
+        if (empty ())
+          free_slots ();
+      }
+
+      //! the handle of the element at `pos`, which stays valid until it is erased
+      GCH_NODISCARD static
+      handle_type
+      handle_of (const const_iterator pos) noexcept
+      {
+        return pos.m_index;
+      }
+
+      GCH_NODISCARD
+      iterator
+      at (const handle_type h) noexcept
+      {
+        return iter (h);
+      }
+
+      GCH_NODISCARD
+      const_iterator
+      at (const handle_type h) const noexcept
+      {
+        return citer (h);
+      }
+
+      //! the generation of the slot of `h`
+      GCH_NODISCARD
+      std::uint32_t
+      generation_of (const handle_type h) const noexcept
+      {
+        return slot_at (h).m_generation;
+      }
+
+      //! whether the slot of `h` is still at `generation`, and so holds the same element
+      GCH_NODISCARD
+      bool
+      is_current (const handle_type h, const std::uint32_t generation) const noexcept
+      {
+        return h != end_index && h < m_slots.size () && slot_at (h).m_generation == generation;
+      }
+
+      template <typename ...Args>
+      iterator
+      emplace (const const_iterator pos, Args&&... args)
+      {
+        static_assert (std::is_trivially_copyable<T>::value,
+                       "slot_list relocates its elements bytewise");
+
+        const std::uint32_t index = acquire ();
+        try
+        {
+          ::new (static_cast<void *> (&m_slots[index].m_storage)) T (std::forward<Args> (args)...);
+        }
+        catch (...)
+        {
+          release (index);
+          throw;
+        }
+        link (pos.m_index, index);
+        return iter (index);
+      }
+
+      template <typename InputIt>
+      iterator
+      insert (const const_iterator pos, InputIt first, const InputIt last)
+      {
+        if (first == last)
+          return iter (pos.m_index);
+
+        const iterator ret = emplace (pos, *first);
+        try
+        {
+          while (++first != last)
+            emplace (pos, *first);
+        }
+        catch (...)
+        {
+          erase (ret, pos);
+          throw;
+        }
+        return ret;
+      }
+
+      iterator
+      erase (const const_iterator pos) noexcept
+      {
+        const std::uint32_t next = slot_at (pos.m_index).m_next;
+        unlink (pos.m_index);
+        value_at (pos.m_index).~T ();
+        release (pos.m_index);
+        return iter (next);
+      }
+
+      iterator
+      erase (const_iterator first, const const_iterator last) noexcept
+      {
+        while (first != last)
+          first = erase (first);
+        return iter (last.m_index);
+      }
+
+      void
+      clear (void) noexcept
+      {
+        erase (cbegin (), cend ());
+      }
+
+      // The elements of `other` get new slots in *this, which may allocate.
+      void
+      splice (const const_iterator pos, slot_list& other)
+      {
+        if (&other == this)
+          return;
+
+        while (! other.empty ())
+          take (pos.m_index, other, other.first_index ());
+      }
+
+      void
+      merge (slot_list& other)
+      {
+        if (&other == this)
+          return;
+
+        std::uint32_t curr = first_index ();
+        while (! other.empty ())
+        {
+          const std::uint32_t src = other.first_index ();
+          while (curr != end_index && ! (other.value_at (src) < value_at (curr)))
+            curr = slot_at (curr).m_next;
+          take (curr, other, src);
+        }
+      }
+
+      void
+      sort (void)
+      {
+        if (m_size < 2)
+          return;
+
+        std::vector<std::uint32_t> indices;
+        indices.reserve (m_size);
+        for (std::uint32_t i = first_index (); i != end_index; i = slot_at (i).m_next)
+          indices.push_back (i);
+
+        std::stable_sort (indices.begin (), indices.end (),
+                          [this](std::uint32_t lhs, std::uint32_t rhs)
+                          {
+                            return value_at (lhs) < value_at (rhs);
+                          });
+
+        std::uint32_t prev = end_index;
+        for (std::uint32_t i : indices)
+        {
+          slot_at (prev).m_next = i;
+          slot_at (i).m_prev    = prev;
+          prev                  = i;
+        }
+        slot_at (prev).m_next      = end_index;
+        slot_at (end_index).m_prev = prev;
+      }
+
+      template <typename Pred>
+      void
+      remove_if (Pred pred)
+      {
+        const_iterator it = cbegin ();
+        while (it != cend ())
+        {
+          if (pred (*it))
+            it = erase (it);
+          else
+            ++it;
+        }
+      }
+
+    private:
+      GCH_NODISCARD
+      iterator
+      iter (std::uint32_t index) noexcept
+      {
+        return iterator (this, index);
+      }
+
+      GCH_NODISCARD
+      const_iterator
+      citer (std::uint32_t index) const noexcept
+      {
+        return const_iterator (this, index);
+      }
+
+      GCH_NODISCARD
+      std::uint32_t
+      first_index (void) const noexcept
+      {
+        return m_slots.empty () ? end_index : slot_at (end_index).m_next;
+      }
+
+      GCH_NODISCARD
+      slot&
+      slot_at (std::uint32_t index) noexcept
+      {
+        return m_slots[index];
+      }
+
+      GCH_NODISCARD
+      const slot&
+      slot_at (std::uint32_t index) const noexcept
+      {
+        return m_slots[index];
+      }
+
+      GCH_NODISCARD
+      T&
+      value_at (std::uint32_t index) noexcept
+      {
+        return *reinterpret_cast<T *> (&m_slots[index].m_storage);
+      }
+
+      GCH_NODISCARD
+      const T&
+      value_at (std::uint32_t index) const noexcept
+      {
+        return *reinterpret_cast<const T *> (&m_slots[index].m_storage);
+      }
+
+      void
+      init (void)
+      {
+        m_slots.push_back (slot { end_index, end_index, 0, { } });
+      }
+
+      // back to the state of a moved-from list
+      void
+      free_slots (void) noexcept
+      {
+        slot_vector (m_slots.get_allocator ()).swap (m_slots);
+        m_free = end_index;
+      }
+
+      std::uint32_t
+      acquire (void)
+      {
+        if (m_slots.empty ())
+          init ();
+
+        if (m_free != end_index)
+        {
+          const std::uint32_t ret = m_free;
+          m_free = slot_at (ret).m_next;
+          slot_at (ret).m_generation = m_generation++;
+          return ret;
+        }
+
+        if (m_slots.size () > (std::numeric_limits<std::uint32_t>::max) ())
+          throw std::length_error ("slot_list ran out of slots");
+
+        m_slots.push_back (slot { end_index, end_index, m_generation++, { } });
+        return static_cast<std::uint32_t> (m_slots.size () - 1);
+      }
+
+      void
+      release (std::uint32_t index) noexcept
+      {
+        slot_at (index).m_next       = m_free;
+        slot_at (index).m_generation = m_generation++;
+        m_free = index;
+      }
+
+      void
+      link (std::uint32_t pos, std::uint32_t index) noexcept
+      {
+        slot& s = slot_at (index);
+        s.m_next = pos;
+        s.m_prev = slot_at (pos).m_prev;
+        slot_at (s.m_prev).m_next = index;
+        slot_at (pos).m_prev      = index;
+        ++m_size;
+      }
+
+      void
+      unlink (std::uint32_t index) noexcept
+      {
+        const slot& s = slot_at (index);
+        slot_at (s.m_prev).m_next = s.m_next;
+        slot_at (s.m_next).m_prev = s.m_prev;
+        --m_size;
+      }
+
+      // move the element at `index` of `other` in front of `pos`
+      void
+      take (std::uint32_t pos, slot_list& other, std::uint32_t index)
+      {
+        emplace (citer (pos), std::move (other.value_at (index)));
+        other.erase (other.citer (index));
+      }
+
+      slot_vector   m_slots;
+      std::uint32_t m_free       = end_index;
+      size_type     m_size       = 0;
+      std::uint32_t m_generation = 0; // kept by the moved-from list
+    };
+
+  } // namespace gch::detail
+
+  ////////////////////
+  // tracker_handle //
+  ////////////////////
+
+  // A weak reference to a binding of a tracker with compact storage (see
+  // tracker_common::get_handle). Copying or dropping one never touches the
+  // tracker, but it must be checked against the tracker which issued it.
+  struct tracker_handle
+  {
+    constexpr
+    tracker_handle (void) noexcept
+      : index      (0),
+        generation (0)
+    { }
+
+    constexpr
+    tracker_handle (std::uint32_t idx, std::uint32_t gen) noexcept
+      : index      (idx),
+        generation (gen)
+    { }
+
+    std::uint32_t index;
+    std::uint32_t generation;
+
+    friend
+    bool
+    operator== (const tracker_handle& lhs, const tracker_handle& rhs) noexcept
+    {
+      return lhs.index == rhs.index && lhs.generation == rhs.generation;
+    }
+
+    friend
+    bool
+    operator!= (const tracker_handle& lhs, const tracker_handle& rhs) noexcept
+    {
+      return ! (lhs == rhs);
+    }
+  };
+
+  namespace storage
+  {
+
+    // Stores reporters in an array of slots linked by 32-bit indices (see
+    // detail::slot_list). Reporters bound to a tracker with this storage keep
+    // a 32-bit id for the tracker and a 32-bit slot index in place of a pointer
+    // and an iterator. Trackers are found by id through a table of every
+    // tracker of that type (see detail::tracker_registry). Reporter positions
+    // are refreshed when the tracker is spliced.
+    //
+    // The reporters must be trivially copyable, which they are. This may be
+    // wrapped by storage::concurrent, but not by the other storage wrappers.
+    template <typename Allocator = std::allocator<void>>
+    struct compact
+    {
+      template <typename T>
+      using allocator_type = typename std::allocator_traits<Allocator>::template
+                               rebind_alloc<T>;
+
+      template <typename T>
+      using container_type = detail::slot_list<T, allocator_type<T>>;
+
+      template <typename T>
+      using iterator_type = detail::slot_list_iterator<T, allocator_type<T>, false>;
+
+      template <typename T>
+      using const_iterator_type = detail::slot_list_iterator<T, allocator_type<T>, true>;
+
+      using is_splice_stable = std::false_type;
+      using is_indexed       = std::false_type;
+      using is_hashed        = std::false_type;
+      using is_tombstoned    = std::false_type;
+      using is_compact       = std::true_type;
+      using is_sorted        = std::false_type;
+      using is_instrumented  = std::false_type;
+      using is_linked        = std::false_type;
+      using is_paired        = std::false_type;
+      using edge_data_type   = void;
+      using lock_type        = void;
+    };
+
+  } // namespace gch::storage
+
+} // namespace gch
+
+#endif // GCH_TRACKER_SLOT_LIST_HPP
@@ -0,0 +1,713 @@
+/** small_list.hpp
+ * Copyright © 2021 Gene Harvey
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license. See the LICENSE file for details.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GCH_TRACKER_SMALL_LIST_HPP
+#define GCH_TRACKER_SMALL_LIST_HPP
+
+#include "common.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace gch
+{
+
+  namespace detail
+  {
+
+    ////////////////
+    // small_list //
+    ////////////////
+
+    struct small_list_node_base
+    {
+      small_list_node_base *m_next;
+      small_list_node_base *m_prev;
+    };
+
+    template <typename T>
+    struct small_list_node
+      : small_list_node_base
+    {
+      template <typename ...Args>
+      explicit
+      small_list_node (Args&&... args)
+        : m_value (std::forward<Args> (args)...)
+      { }
+
+      T m_value;
+    };
+
+    template <typename T, std::size_t N, typename Allocator>
+    class small_list;
+
+    // Kept outside of small_list so that the iterator type may be named while
+    // T is still incomplete (T usually holds one of these iterators).
+    template <typename T, bool IsConst>
+    class small_list_iterator
+    {
+      using node_base = small_list_node_base;
+      using node      = small_list_node<T>;
+
+    public:
+      using difference_type   = std::ptrdiff_t;
+      using value_type        = T;
+      using pointer           = typename std::conditional<IsConst, const T *, T *>::type;
+      using reference         = typename std::conditional<IsConst, const T&, T&>::type;
+      using iterator_category = std::bidirectional_iterator_tag;
+
+      small_list_iterator            (void)                          = default;
+      small_list_iterator            (const small_list_iterator&)     = default;
+      small_list_iterator            (small_list_iterator&&) noexcept = default;
+      small_list_iterator& operator= (const small_list_iterator&)     = default;
+      small_list_iterator& operator= (small_list_iterator&&) noexcept = default;
+      ~small_list_iterator           (void)                          = default;
+
+      template <bool C = IsConst, typename std::enable_if<C>::type * = nullptr>
+      /* implicit */
+      small_list_iterator (const small_list_iterator<T, false>& other) noexcept
+        : m_node (other.m_node)
+      { }
+
+    private:
+      template <typename, std::size_t, typename>
+      friend class small_list;
+
+      template <typename, bool>
+      friend class small_list_iterator;
+
+      explicit
+      small_list_iterator (node_base *n) noexcept
+        : m_node (n)
+      { }
+
+    public:
+      small_list_iterator&
+      operator++ (void) noexcept
+      {
+        m_node = m_node->m_next;
+        return *this;
+      }
+
+      small_list_iterator
+      operator++ (int) noexcept
+      {
+        small_list_iterator ret (*this);
+        ++*this;
+        return ret;
+      }
+
+      small_list_iterator&
+      operator-- (void) noexcept
+      {
+        m_node = m_node->m_prev;
+        return *this;
+      }
+
+      small_list_iterator
+      operator-- (int) noexcept
+      {
+        small_list_iterator ret (*this);
+        --*this;
+        return ret;
+      }
+
+      reference
+      operator* (void) const noexcept
+      {
+        return static_cast<node *> (m_node)->m_value;
+      }
+
+      pointer
+      operator-> (void) const noexcept
+      {
+        return &**this;
+      }
+
+      friend
+      bool
+      operator== (const small_list_iterator& lhs, const small_list_iterator& rhs) noexcept
+      {
+        return lhs.m_node == rhs.m_node;
+      }
+
+      friend
+      bool
+      operator!= (const small_list_iterator& lhs, const small_list_iterator& rhs) noexcept
+      {
+        return lhs.m_node != rhs.m_node;
+      }
+
+    private:
+      node_base *m_node = nullptr;
+    };
+
+    // A doubly-linked list which keeps its first N nodes inside the object and
+    // only allocates once those are in use. Nodes never move while they are in
+    // the list, with the exception of inline nodes, which are relocated when
+    // the list is moved or spliced into another list. Erased heap nodes are
+    // kept as spares for the next insertion until the list is trimmed.
+    template <typename T, std::size_t N, typename Allocator = std::allocator<T>>
+    class small_list
+    {
+      static_assert (0 < N, "small_list requires an inline capacity of at least 1");
+
+      using node_base = small_list_node_base;
+      using node      = small_list_node<T>;
+
+      using node_allocator    = typename std::allocator_traits<Allocator>::template
+                                  rebind_alloc<node>;
+      using node_alloc_traits = std::allocator_traits<node_allocator>;
+      using node_storage      = typename std::aligned_storage<sizeof (node),
+                                                              alignof (node)>::type;
+
+    public:
+      using value_type      = T;
+      using allocator_type  = Allocator;
+      using size_type       = std::size_t;
+      using difference_type = std::ptrdiff_t;
+      using reference       = value_type&;
+      using const_reference = const value_type&;
+      using pointer         = value_type *;
+      using const_pointer   = const value_type *;
+
+      using iterator               = small_list_iterator<T, false>;
+      using const_iterator         = small_list_iterator<T, true>;
+      using reverse_iterator       = std::reverse_iterator<iterator>;
+      using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+//    small_list            (void)                  = impl;
+      small_list            (const small_list&)     = delete;
+//    small_list            (small_list&&) noexcept = impl;
+      small_list& operator= (const small_list&)     = delete;
+//    small_list& operator= (small_list&&) noexcept = impl;
+//    ~small_list           (void)                  = impl;
+
+      small_list (void) noexcept
+        : m_alloc ()
+      {
+        init ();
+      }
+
+      explicit
+      small_list (const allocator_type& alloc) noexcept
+        : m_alloc (alloc)
+      {
+        init ();
+      }
+
+      // only inline elements are relocated; heap nodes are taken over as they are
+      small_list (small_list&& other) noexcept
+        : m_alloc (std::move (other.m_alloc))
+      {
+        init ();
+        steal (other);
+      }
+
+      small_list&
+      operator= (small_list&& other) noexcept
+      {
+        if (&other != this)
+        {
+          clear ();
+          trim ();
+          move_allocator (other, typename node_alloc_traits::
+                                   propagate_on_container_move_assignment { });
+          steal (other);
+        }
+        return *this;
+      }
+
+      ~small_list (void)
+      {
+        clear ();
+        trim ();
+      }
+
+      void
+      swap (small_list& other) noexcept
+      {
+        if (&other != this)
+        {
+          small_list tmp (std::move (other));
+          other = std::move (*this);
+          *this = std::move (tmp);
+        }
+      }
+
+      GCH_NODISCARD
+      allocator_type
+      get_allocator (void) const noexcept
+      {
+        return allocator_type (m_alloc);
+      }
+
+      GCH_NODISCARD iterator       begin  (void)       noexcept { return iterator (m_end.m_next); }
+      GCH_NODISCARD const_iterator begin  (void) const noexcept { return cbegin (); }
+      GCH_NODISCARD const_iterator cbegin (void) const noexcept { return citer (m_end.m_next); }
+
+      GCH_NODISCARD iterator       end    (void)       noexcept { return iterator (&m_end); }
+      GCH_NODISCARD const_iterator end    (void) const noexcept { return cend (); }
+      GCH_NODISCARD const_iterator cend   (void) const noexcept { return citer (&m_end); }
+
+      GCH_NODISCARD
+      reverse_iterator
+      rbegin (void) noexcept
+      {
+        return reverse_iterator { end () };
+      }
+
+      GCH_NODISCARD
+      const_reverse_iterator
+      rbegin (void) const noexcept
+      {
+        return crbegin ();
+      }
+
+      GCH_NODISCARD
+      const_reverse_iterator
+      crbegin (void) const noexcept
+      {
+        return const_reverse_iterator { cend () };
+      }
+
+      GCH_NODISCARD
+      reverse_iterator
+      rend (void) noexcept
+      {
+        return reverse_iterator { begin () };
+      }
+
+      GCH_NODISCARD
+      const_reverse_iterator
+      rend (void) const noexcept
+      {
+        return crend ();
+      }
+
+      GCH_NODISCARD
+      const_reverse_iterator
+      crend (void) const noexcept
+      {
+        return const_reverse_iterator { cbegin () };
+      }
+
+      GCH_NODISCARD reference       front (void)       { return *begin ();  }
+      GCH_NODISCARD const_reference front (void) const { return *cbegin (); }
+
+      GCH_NODISCARD reference       back  (void)       { return *--end ();  }
+      GCH_NODISCARD const_reference back  (void) const { return *--cend (); }
+
+      GCH_NODISCARD
+      bool
+      empty (void) const noexcept
+      {
+        return m_size == 0;
+      }
+
+      GCH_NODISCARD
+      size_type
+      size (void) const noexcept
+      {
+        return m_size;
+      }
+
+      GCH_NODISCARD
+      size_type
+      max_size (void) const noexcept
+      {
+        return node_alloc_traits::max_size (m_alloc);
+      }
+
+      GCH_NODISCARD static constexpr
+      size_type
+      inline_capacity (void) noexcept
+      {
+        return N;
+      }
+
+      //! the number of elements which fit without allocating
+      GCH_NODISCARD
+      size_type
+      capacity (void) const noexcept
+      {
+        size_type num_free = 0;
+        for (const node_base *n = m_free; n != nullptr; n = n->m_next)
+          ++num_free;
+        return m_size + num_free + m_num_spare;
+      }
+
+      //! allocates spare heap nodes so that the list may grow to `n` elements without allocating
+      void
+      reserve (size_type n)
+      {
+        for (size_type cap = capacity (); cap < n; ++cap)
+        {
+          node_base *slot = ::new (static_cast<void *> (node_alloc_traits::allocate (m_alloc, 1)))
+                              node_base;
+          slot->m_next = m_spare;
+          m_spare = slot;
+          ++m_num_spare;
+        }
+      }
+
+      //! nodes are never relocated to fill the inline buffer, so this only frees the spares
+      void
+      shrink_to_fit (void) noexcept
+      {
+        trim ();
+      }
+
+      //! frees the spare heap nodes
+      void
+      trim (void) noexcept
+      {
+        while (m_spare != nullptr)
+        {
+          node_base *next = m_spare->m_next;
+          node_alloc_traits::deallocate (m_alloc, static_cast<node *> (m_spare), 1);
+          m_spare = next;
+        }
+        m_num_spare = 0;
+      }
+
+      template <typename ...Args>
+      iterator
+      emplace (const const_iterator pos, Args&&... args)
+      {
+        node_base *slot = acquire ();
+        try
+        {
+          link (pos.m_node, ::new (static_cast<void *> (slot)) node (std::forward<Args> (args)...));
+        }
+        catch (...)
+        {
+          release (slot);
+          throw;
+        }
+        return iterator { slot };
+      }
+
+      template <typename InputIt>
+      iterator
+      insert (const const_iterator pos, InputIt first, const InputIt last)
+      {
+        if (first == last)
+          return iterator { pos.m_node };
+
+        const iterator ret = emplace (pos, *first);
+        try
+        {
+          while (++first != last)
+            emplace (pos, *first);
+        }
+        catch (...)
+        {
+          erase (ret, pos);
+          throw;
+        }
+        return ret;
+      }
+
+      iterator
+      erase (const const_iterator pos) noexcept
+      {
+        node_base *next = pos.m_node->m_next;
+        unlink (pos.m_node);
+        destroy (static_cast<node *> (pos.m_node));
+        return iterator { next };
+      }
+
+      iterator
+      erase (const_iterator first, const const_iterator last) noexcept
+      {
+        while (first != last)
+          first = erase (first);
+        return iterator { last.m_node };
+      }
+
+      void
+      clear (void) noexcept
+      {
+        erase (cbegin (), cend ());
+      }
+
+      // Heap nodes are relinked. Inline nodes are relocated, which may allocate.
+      void
+      splice (const const_iterator pos, small_list& other)
+      {
+        if (&other == this)
+          return;
+
+        while (! other.empty ())
+          take (pos.m_node, other, other.m_end.m_next);
+      }
+
+      void
+      merge (small_list& other)
+      {
+        if (&other == this)
+          return;
+
+        node_base *curr = m_end.m_next;
+        while (! other.empty ())
+        {
+          node_base *src = other.m_end.m_next;
+          while (curr != &m_end && ! (value_of (src) < value_of (curr)))
+            curr = curr->m_next;
+          take (curr, other, src);
+        }
+      }
+
+      void
+      sort (void)
+      {
+        if (m_size < 2)
+          return;
+
+        std::vector<node_base *> nodes;
+        nodes.reserve (m_size);
+        for (node_base *n = m_end.m_next; n != &m_end; n = n->m_next)
+          nodes.push_back (n);
+
+        std::stable_sort (nodes.begin (), nodes.end (),
+                          [](const node_base *lhs, const node_base *rhs)
+                          {
+                            return value_of (lhs) < value_of (rhs);
+                          });
+
+        node_base *prev = &m_end;
+        for (node_base *n : nodes)
+        {
+          prev->m_next = n;
+          n->m_prev    = prev;
+          prev         = n;
+        }
+        prev->m_next  = &m_end;
+        m_end.m_prev = prev;
+      }
+
+      template <typename Pred>
+      void
+      remove_if (Pred pred)
+      {
+        const_iterator it = cbegin ();
+        while (it != cend ())
+        {
+          if (pred (*it))
+            it = erase (it);
+          else
+            ++it;
+        }
+      }
+
+    private:
+      static
+      const_iterator
+      citer (const node_base *n) noexcept
+      {
+        return const_iterator { const_cast<node_base *> (n) };
+      }
+
+      static
+      const T&
+      value_of (const node_base *n) noexcept
+      {
+        return static_cast<const node *> (n)->m_value;
+      }
+
+      void
+      init (void) noexcept
+      {
+        m_end.m_next = &m_end;
+        m_end.m_prev = &m_end;
+        m_size       = 0;
+
+        m_spare     = nullptr;
+        m_num_spare = 0;
+
+        m_free = nullptr;
+        for (std::size_t i = N; 0 < i; --i)
+        {
+          node_base *slot = ::new (static_cast<void *> (&m_buffer[i - 1])) node_base;
+          slot->m_next = m_free;
+          m_free = slot;
+        }
+      }
+
+      GCH_NODISCARD
+      bool
+      is_inline (const node_base *n) const noexcept
+      {
+        const void *p = n;
+        return ! std::less<const void *> { } (p, &m_buffer[0])
+             &&  std::less<const void *> { } (p, &m_buffer[N]);
+      }
+
+      node_base *
+      acquire (void)
+      {
+        if (m_free != nullptr)
+        {
+          node_base *ret = m_free;
+          m_free = m_free->m_next;
+          return ret;
+        }
+
+        if (m_spare != nullptr)
+        {
+          node_base *ret = m_spare;
+          m_spare = m_spare->m_next;
+          --m_num_spare;
+          return ret;
+        }
+        return node_alloc_traits::allocate (m_alloc, 1);
+      }
+
+      void
+      release (node_base *slot) noexcept
+      {
+        if (is_inline (slot))
+        {
+          slot->m_next = m_free;
+          m_free = slot;
+        }
+        else
+        {
+          slot->m_next = m_spare;
+          m_spare = slot;
+          ++m_num_spare;
+        }
+      }
+
+      void
+      destroy (node *n) noexcept
+      {
+        n->~node ();
+        release (::new (static_cast<void *> (n)) node_base);
+      }
+
+      void
+      link (node_base *pos, node_base *n) noexcept
+      {
+        n->m_next = pos;
+        n->m_prev = pos->m_prev;
+        pos->m_prev->m_next = n;
+        pos->m_prev = n;
+        ++m_size;
+      }
+
+      void
+      unlink (node_base *n) noexcept
+      {
+        n->m_prev->m_next = n->m_next;
+        n->m_next->m_prev = n->m_prev;
+        --m_size;
+      }
+
+      // move the node `n` of `other` in front of `pos`
+      void
+      take (node_base *pos, small_list& other, node_base *n)
+      {
+        if (other.is_inline (n))
+        {
+          emplace (citer (pos), std::move (static_cast<node *> (n)->m_value));
+          other.unlink (n);
+          other.destroy (static_cast<node *> (n));
+        }
+        else
+        {
+          other.unlink (n);
+          link (pos, n);
+        }
+      }
+
+      // heap nodes are taken over, so the allocators must be equal afterward
+      template <typename Propagate = std::true_type>
+      void
+      move_allocator (small_list& other, Propagate) noexcept
+      {
+        m_alloc = std::move (other.m_alloc);
+      }
+
+      void
+      move_allocator (small_list&, std::false_type) noexcept { }
+
+      // `*this` must be empty and have no spares, so inline elements of `other`
+      // always fit inline
+      void
+      steal (small_list& other) noexcept
+      {
+        m_spare     = other.m_spare;
+        m_num_spare = other.m_num_spare;
+        other.m_spare     = nullptr;
+        other.m_num_spare = 0;
+
+        while (! other.empty ())
+          take (&m_end, other, other.m_end.m_next);
+      }
+
+      node_allocator m_alloc;
+      node_base      m_end;
+      node_base     *m_free;
+      node_base     *m_spare;
+      size_type      m_num_spare;
+      size_type      m_size;
+      node_storage   m_buffer[N];
+    };
+
+  } // namespace gch::detail
+
+  namespace storage
+  {
+
+    // Stores the first N reporters inside the tracker. Reporter positions are
+    // refreshed when the tracker is moved or spliced.
+    template <std::size_t N, typename Allocator = std::allocator<void>>
+    struct small
+    {
+      template <typename T>
+      using container_type = detail::small_list<
+        T, N, typename std::allocator_traits<Allocator>::template rebind_alloc<T>>;
+
+      template <typename T>
+      using iterator_type = detail::small_list_iterator<T, false>;
+
+      template <typename T>
+      using const_iterator_type = detail::small_list_iterator<T, true>;
+
+      using is_splice_stable = std::false_type;
+      using is_indexed       = std::false_type;
+      using is_hashed        = std::false_type;
+      using is_tombstoned    = std::false_type;
+      using is_compact       = std::false_type;
+      using is_sorted        = std::false_type;
+      using is_instrumented  = std::false_type;
+      using is_linked        = std::false_type;
+      using is_paired        = std::false_type;
+      using edge_data_type   = void;
+      using lock_type        = void;
+    };
+
+#ifdef GCH_LIB_MEMORY_RESOURCE
+    namespace pmr
+    {
+
+      template <std::size_t N>
+      using small = storage::small<N, std::pmr::polymorphic_allocator<std::byte>>;
+
+    } // namespace gch::storage::pmr
+#endif
+
+  } // namespace gch::storage
+
+} // namespace gch
+
+#endif // GCH_TRACKER_SMALL_LIST_HPP
@@ -0,0 +1,530 @@
+/** sorted_list.hpp
+ * Copyright © 2021 Gene Harvey
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license. See the LICENSE file for details.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GCH_TRACKER_SORTED_LIST_HPP
+#define GCH_TRACKER_SORTED_LIST_HPP
+
+#include "common.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace gch
+{
+
+  namespace detail
+  {
+
+    /////////////////
+    // sorted_list //
+    /////////////////
+
+    // A list which keeps its reporters ordered by the address of their remotes.
+    // Every insertion goes to the sorted position, whatever position it is
+    // given. The positions are also kept in a vector ordered by remote, so that
+    // the insert position is found by binary search.
+    //
+    // Anything which changes the remote of an element in place must go through
+    // `modify`. If that puts the element out of order, the list is re-sorted
+    // before the next insertion, splice, or merge (see `is_sorted`).
+    template <typename Storage, typename T>
+    class sorted_list
+    {
+      using list_type = tracker_container<Storage, T>;
+
+    public:
+      using value_type             = T;
+      using allocator_type         = typename list_type::allocator_type;
+      using size_type              = typename list_type::size_type;
+      using difference_type        = typename list_type::difference_type;
+      using reference              = typename list_type::reference;
+      using const_reference        = typename list_type::const_reference;
+      using pointer                = typename list_type::pointer;
+      using const_pointer          = typename list_type::const_pointer;
+      using iterator               = typename list_type::iterator;
+      using const_iterator         = typename list_type::const_iterator;
+      using reverse_iterator       = typename list_type::reverse_iterator;
+      using const_reverse_iterator = typename list_type::const_reverse_iterator;
+
+    private:
+      struct entry
+      {
+        const void *m_key;
+        iterator    m_pos;
+      };
+
+      using entry_allocator = typename std::allocator_traits<allocator_type>::template
+                                rebind_alloc<entry>;
+      using entry_vector    = std::vector<entry, entry_allocator>;
+
+    public:
+      sorted_list            (void)                   = default;
+      sorted_list            (const sorted_list&)     = delete;
+//    sorted_list            (sorted_list&&) noexcept = impl;
+      sorted_list& operator= (const sorted_list&)     = delete;
+//    sorted_list& operator= (sorted_list&&) noexcept = impl;
+      ~sorted_list           (void)                   = default;
+
+      sorted_list (sorted_list&& other) noexcept
+        : m_list      (std::move (other.m_list)),
+          m_index     (std::move (other.m_index)),
+          m_is_sorted (other.m_is_sorted)
+      {
+        other.m_index.clear ();
+        other.m_is_sorted = true;
+        relocated ();
+      }
+
+      sorted_list&
+      operator= (sorted_list&& other) noexcept
+      {
+        m_list = std::move (other.m_list);
+        m_index.swap (other.m_index);
+        other.m_index.clear ();
+        m_is_sorted = other.m_is_sorted;
+        other.m_is_sorted = true;
+        relocated ();
+        return *this;
+      }
+
+      explicit
+      sorted_list (const allocator_type& alloc)
+        : m_list  (alloc),
+          m_index (entry_allocator (alloc))
+      { }
+
+      void
+      swap (sorted_list& other) noexcept
+      {
+        using std::swap;
+        m_list.swap (other.m_list);
+        m_index.swap (other.m_index);
+        swap (m_is_sorted, other.m_is_sorted);
+        relocated ();
+        other.relocated ();
+      }
+
+      GCH_NODISCARD
+      allocator_type
+      get_allocator (void) const noexcept
+      {
+        return m_list.get_allocator ();
+      }
+
+      GCH_NODISCARD iterator       begin  (void)       noexcept { return m_list.begin ();  }
+      GCH_NODISCARD const_iterator begin  (void) const noexcept { return m_list.begin ();  }
+      GCH_NODISCARD const_iterator cbegin (void) const noexcept { return m_list.cbegin (); }
+
+      GCH_NODISCARD iterator       end    (void)       noexcept { return m_list.end ();    }
+      GCH_NODISCARD const_iterator end    (void) const noexcept { return m_list.end ();    }
+      GCH_NODISCARD const_iterator cend   (void) const noexcept { return m_list.cend ();   }
+
+      GCH_NODISCARD
+      reverse_iterator
+      rbegin (void) noexcept
+      {
+        return m_list.rbegin ();
+      }
+
+      GCH_NODISCARD
+      const_reverse_iterator
+      rbegin (void) const noexcept
+      {
+        return m_list.rbegin ();
+      }
+
+      GCH_NODISCARD
+      const_reverse_iterator
+      crbegin (void) const noexcept
+      {
+        return m_list.crbegin ();
+      }
+
+      GCH_NODISCARD
+      reverse_iterator
+      rend (void) noexcept
+      {
+        return m_list.rend ();
+      }
+
+      GCH_NODISCARD
+      const_reverse_iterator
+      rend (void) const noexcept
+      {
+        return m_list.rend ();
+      }
+
+      GCH_NODISCARD
+      const_reverse_iterator
+      crend (void) const noexcept
+      {
+        return m_list.crend ();
+      }
+
+      GCH_NODISCARD reference       front (void)       { return m_list.front (); }
+      GCH_NODISCARD const_reference front (void) const { return m_list.front (); }
+
+      GCH_NODISCARD reference       back  (void)       { return m_list.back ();  }
+      GCH_NODISCARD const_reference back  (void) const { return m_list.back ();  }
+
+      GCH_NODISCARD
+      bool
+      empty (void) const noexcept
+      {
+        return m_list.empty ();
+      }
+
+      GCH_NODISCARD
+      size_type
+      size (void) const noexcept
+      {
+        return m_list.size ();
+      }
+
+      GCH_NODISCARD
+      size_type
+      max_size (void) const noexcept
+      {
+        return m_list.max_size ();
+      }
+
+      GCH_NODISCARD
+      size_type
+      capacity (void) const noexcept
+      {
+        return m_list.capacity ();
+      }
+
+      void
+      reserve (size_type n)
+      {
+        m_index.reserve (n);
+        m_list.reserve (n);
+      }
+
+      void
+      shrink_to_fit (void)
+      {
+        m_index.shrink_to_fit ();
+        m_list.shrink_to_fit ();
+        reindex ();
+      }
+
+      void
+      trim (void) noexcept
+      {
+        m_list.trim ();
+      }
+
+      //! only available if the underlying storage is indexed
+      GCH_NODISCARD
+      size_type
+      index_of (const const_iterator pos) const noexcept
+      {
+        return m_list.index_of (pos);
+      }
+
+      //! whether the elements are in order; false only if `modify` has put one out of order
+      GCH_NODISCARD
+      bool
+      is_sorted (void) const noexcept
+      {
+        return m_is_sorted;
+      }
+
+      //! the first element whose remote is not before `key`
+      GCH_NODISCARD
+      const_iterator
+      lower_bound (const void *remote) const noexcept
+      {
+        const auto it = std::lower_bound (m_index.begin (), m_index.end (), remote, key_less { });
+        return it != m_index.end () ? const_iterator (it->m_pos) : cend ();
+      }
+
+      //! returns an element whose remote is at `remote`, or `end ()` if there is none
+      GCH_NODISCARD
+      iterator
+      find (const void *remote) noexcept
+      {
+        const auto it = std::lower_bound (m_index.begin (), m_index.end (), remote, key_less { });
+        return (it != m_index.end () && it->m_key == remote) ? it->m_pos : end ();
+      }
+
+      GCH_NODISCARD
+      const_iterator
+      find (const void *remote) const noexcept
+      {
+        return const_cast<sorted_list&> (*this).find (remote);
+      }
+
+      //! changes the remote of `e`, which must be an element of `*this`, with `f`
+      template <typename Function>
+      void
+      modify (value_type& e, Function f) noexcept
+      {
+        const iterator pos = unindex (e);
+        f (e);
+
+        // the entry was just erased, so this never allocates
+        const auto it = std::upper_bound (m_index.begin (), m_index.end (), key (e), key_less { });
+        m_index.insert (it, entry { key (e), pos });
+
+        if (m_is_sorted && ! is_in_order (pos))
+          m_is_sorted = false;
+      }
+
+      //! `pos` is ignored; the element goes after any others with the same remote
+      template <typename ...Args>
+      iterator
+      emplace (const const_iterator, Args&&... args)
+      {
+        if (m_index.size () == m_index.capacity ())
+          m_index.reserve (m_index.empty () ? 8 : 2 * m_index.size ());
+        restore_order ();
+
+        // the elements are cheap to copy, so make one to find where it goes
+        value_type e (std::forward<Args> (args)...);
+        const auto it = std::upper_bound (m_index.begin (), m_index.end (), key (e), key_less { });
+        const iterator pos = m_list.emplace (it != m_index.end () ? it->m_pos : end (),
+                                             std::move (e));
+        m_index.insert (it, entry { key (*pos), pos });
+        return pos;
+      }
+
+      //! the elements are not contiguous afterward; returns the position of the first
+      template <typename InputIt>
+      iterator
+      insert (const const_iterator pos, InputIt first, const InputIt last)
+      {
+        if (first == last)
+          return m_list.erase (pos, pos);
+
+        std::vector<iterator> inserted;
+        try
+        {
+          for (; first != last; ++first)
+          {
+            if (inserted.size () == inserted.capacity ())
+              inserted.reserve (2 * inserted.size () + 1);
+            inserted.push_back (emplace (pos, *first));
+          }
+        }
+        catch (...)
+        {
+          for (const iterator it : inserted)
+            erase (it);
+          throw;
+        }
+        return inserted.front ();
+      }
+
+      iterator
+      erase (const const_iterator pos) noexcept
+      {
+        unindex (*pos);
+        return m_list.erase (pos);
+      }
+
+      iterator
+      erase (const_iterator first, const const_iterator last) noexcept
+      {
+        for (const_iterator it = first; it != last; ++it)
+          unindex (*it);
+        return m_list.erase (first, last);
+      }
+
+      void
+      clear (void) noexcept
+      {
+        m_index.clear ();
+        m_list.clear ();
+        m_is_sorted = true;
+      }
+
+      //! `pos` is ignored; the elements of `other` are merged in
+      void
+      splice (const const_iterator pos, sorted_list& other)
+      {
+        if (empty ())
+        {
+          // take the index from `other` along with its elements
+          m_list.splice (pos, other.m_list);
+          m_index.swap (other.m_index);
+          other.m_index.clear ();
+          m_is_sorted = other.m_is_sorted;
+          other.m_is_sorted = true;
+          relocated ();
+          return;
+        }
+        merge (other);
+      }
+
+      void
+      merge (sorted_list& other)
+      {
+        m_index.reserve (size () + other.size ());
+        restore_order ();
+        other.restore_order ();
+
+        m_list.merge (other.m_list);
+        other.m_index.clear ();
+        reindex ();
+      }
+
+      void
+      sort (void)
+      {
+        restore_order ();
+      }
+
+      template <typename Pred>
+      void
+      remove_if (Pred pred)
+      {
+        m_list.remove_if (pred);
+        reindex ();
+      }
+
+    private:
+      struct key_less
+      {
+        bool
+        operator() (const entry& lhs, const void *rhs) const noexcept
+        {
+          return std::less<const void *> { } (lhs.m_key, rhs);
+        }
+
+        bool
+        operator() (const void *lhs, const entry& rhs) const noexcept
+        {
+          return std::less<const void *> { } (lhs, rhs.m_key);
+        }
+
+        bool
+        operator() (const entry& lhs, const entry& rhs) const noexcept
+        {
+          return std::less<const void *> { } (lhs.m_key, rhs.m_key);
+        }
+      };
+
+      static
+      const void *
+      key (const value_type& e) noexcept
+      {
+        return e.get_remote_base_ptr ();
+      }
+
+      //! removes the entry for `e`, which must be indexed under its current remote
+      iterator
+      unindex (const value_type& e) noexcept
+      {
+        auto it = std::lower_bound (m_index.begin (), m_index.end (), key (e), key_less { });
+        while (&*it->m_pos != &e)
+        {
+          assert (it->m_key == key (e) && "the element was not indexed");
+          ++it;
+        }
+
+        const iterator ret = it->m_pos;
+        m_index.erase (it);
+        return ret;
+      }
+
+      GCH_NODISCARD
+      bool
+      is_in_order (const iterator pos) const noexcept
+      {
+        if (pos != m_list.begin () && *pos < *std::prev (pos))
+          return false;
+        const iterator next = std::next (pos);
+        return next == m_list.end () || ! (*next < *pos);
+      }
+
+      void
+      restore_order (void)
+      {
+        if (! m_is_sorted)
+        {
+          m_list.sort ();
+          m_is_sorted = true;
+        }
+      }
+
+      // only uses the current allocation, since there is never more than one entry per element
+      void
+      reindex (void) noexcept
+      {
+        m_index.clear ();
+        for (iterator it = begin (); it != end (); ++it)
+          m_index.push_back (entry { key (*it), it });
+
+        if (! m_is_sorted)
+          std::stable_sort (m_index.begin (), m_index.end (), key_less { });
+      }
+
+      void
+      relocated (void) noexcept
+      {
+        if (! Storage::is_splice_stable::value)
+          reindex ();
+      }
+
+      list_type    m_list;
+      entry_vector m_index;
+      bool         m_is_sorted = true;
+    };
+
+  } // namespace gch::detail
+
+  namespace storage
+  {
+
+    // Wraps another storage so that the reporters are always kept sorted by the
+    // address of their remotes (see detail::sorted_list). Insertion finds its
+    // position in O(log n), `is_sorted` is O(1), and merges need not check
+    // their operands. Costs two extra words per reporter. This must be the
+    // outermost storage policy, apart from `concurrent`.
+    template <typename Base = list>
+    struct sorted
+    {
+      static_assert (! Base::is_hashed::value, "sorted storage may not be hashed");
+      static_assert (! Base::is_tombstoned::value, "sorted storage may not be tombstoned");
+      static_assert (! Base::is_compact::value, "compact storage may not be wrapped");
+      static_assert (! Base::is_linked::value, "linked storage may not be wrapped");
+      static_assert (! Base::is_paired::value, "paired storage may not be wrapped");
+
+      template <typename T>
+      using container_type = detail::sorted_list<Base, T>;
+
+      template <typename T>
+      using iterator_type = typename Base::template iterator_type<T>;
+
+      template <typename T>
+      using const_iterator_type = typename Base::template const_iterator_type<T>;
+
+      using is_splice_stable = typename Base::is_splice_stable;
+      using is_indexed       = typename Base::is_indexed;
+      using is_hashed        = std::false_type;
+      using is_tombstoned    = std::false_type;
+      using is_compact       = std::false_type;
+      using is_sorted        = std::true_type;
+      using is_instrumented  = typename Base::is_instrumented;
+      using is_linked        = std::false_type;
+      using is_paired        = std::false_type;
+      using edge_data_type   = typename Base::edge_data_type;
+      using lock_type        = typename Base::lock_type;
+    };
+
+  } // namespace gch::storage
+
+} // namespace gch
+
+#endif // GCH_TRACKER_SORTED_LIST_HPP
@@ -0,0 +1,454 @@
+/** tombstone_list.hpp
+ * Copyright © 2021 Gene Harvey
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license. See the LICENSE file for details.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GCH_TRACKER_TOMBSTONE_LIST_HPP
+#define GCH_TRACKER_TOMBSTONE_LIST_HPP
+
+#include "common.hpp"
+
+#include <atomic>
+#include <cstddef>
+
+namespace gch
+{
+
+  namespace detail
+  {
+
+    ////////////////////
+    // tombstone_list //
+    ////////////////////
+
+    template <typename T>
+    struct tombstone_list_node
+    {
+      template <typename ...Args>
+      explicit
+      tombstone_list_node (Args&&... args)
+        noexcept (std::is_nothrow_constructible<T, Args...>::value)
+        : m_value (std::forward<Args> (args)...)
+      { }
+
+      // for storage which relocates its nodes
+      tombstone_list_node (tombstone_list_node&& other) noexcept
+        : m_value   (std::move (other.m_value)),
+          m_is_dead (other.m_is_dead.load (std::memory_order_relaxed))
+      { }
+
+      friend
+      bool
+      operator< (const tombstone_list_node& lhs, const tombstone_list_node& rhs)
+      {
+        return lhs.m_value < rhs.m_value;
+      }
+
+      T                         m_value;
+      mutable std::atomic<bool> m_is_dead { false };
+    };
+
+    // A list whose elements may be marked as dead from any thread with `kill`,
+    // which only touches atomics. Dead elements are erased by `compact`, which
+    // is run at the start of iteration and before anything which restructures
+    // the list. Since `begin` compacts, it may invalidate iterators to dead
+    // elements, exactly as erasing them would have.
+    template <typename Storage, typename T>
+    class tombstone_list
+    {
+      using node      = tombstone_list_node<T>;
+      using list_type = tracker_container<Storage, node>;
+
+    public:
+      using value_type      = T;
+      using allocator_type  = typename list_type::allocator_type;
+      using size_type       = typename list_type::size_type;
+      using difference_type = typename list_type::difference_type;
+      using reference       = value_type&;
+      using const_reference = const value_type&;
+      using pointer         = value_type *;
+      using const_pointer   = const value_type *;
+
+      using iterator       = node_value_iterator<T, typename list_type::iterator>;
+      using const_iterator = node_value_iterator<T, typename list_type::const_iterator>;
+
+      using reverse_iterator       = std::reverse_iterator<iterator>;
+      using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+      tombstone_list            (void)                      = default;
+      tombstone_list            (const tombstone_list&)     = delete;
+//    tombstone_list            (tombstone_list&&) noexcept = impl;
+      tombstone_list& operator= (const tombstone_list&)     = delete;
+//    tombstone_list& operator= (tombstone_list&&) noexcept = impl;
+      ~tombstone_list           (void)                      = default;
+
+      tombstone_list (tombstone_list&& other) noexcept
+        : m_list ((other.compact (), std::move (other.m_list)))
+      { }
+
+      tombstone_list&
+      operator= (tombstone_list&& other) noexcept
+      {
+        other.compact ();
+        m_list = std::move (other.m_list);
+        m_num_dead.store (0, std::memory_order_relaxed);
+        return *this;
+      }
+
+      explicit
+      tombstone_list (const allocator_type& alloc)
+        : m_list (alloc)
+      { }
+
+      void
+      swap (tombstone_list& other) noexcept
+      {
+        compact ();
+        other.compact ();
+        m_list.swap (other.m_list);
+      }
+
+      GCH_NODISCARD
+      allocator_type
+      get_allocator (void) const noexcept
+      {
+        return m_list.get_allocator ();
+      }
+
+      GCH_NODISCARD
+      iterator
+      begin (void) noexcept
+      {
+        compact ();
+        return iterator (m_list.begin ());
+      }
+
+      GCH_NODISCARD
+      const_iterator
+      begin (void) const noexcept
+      {
+        return cbegin ();
+      }
+
+      GCH_NODISCARD
+      const_iterator
+      cbegin (void) const noexcept
+      {
+        compact ();
+        return citer (m_list.cbegin ());
+      }
+
+      GCH_NODISCARD iterator       end  (void)       noexcept { return iterator (m_list.end ()); }
+      GCH_NODISCARD const_iterator end  (void) const noexcept { return cend (); }
+      GCH_NODISCARD const_iterator cend (void) const noexcept { return citer (m_list.cend ()); }
+
+      GCH_NODISCARD
+      reverse_iterator
+      rbegin (void) noexcept
+      {
+        compact ();
+        return reverse_iterator { end () };
+      }
+
+      GCH_NODISCARD
+      const_reverse_iterator
+      rbegin (void) const noexcept
+      {
+        return crbegin ();
+      }
+
+      GCH_NODISCARD
+      const_reverse_iterator
+      crbegin (void) const noexcept
+      {
+        compact ();
+        return const_reverse_iterator { cend () };
+      }
+
+      GCH_NODISCARD
+      reverse_iterator
+      rend (void) noexcept
+      {
+        return reverse_iterator { iterator (m_list.begin ()) };
+      }
+
+      GCH_NODISCARD
+      const_reverse_iterator
+      rend (void) const noexcept
+      {
+        return crend ();
+      }
+
+      GCH_NODISCARD
+      const_reverse_iterator
+      crend (void) const noexcept
+      {
+        return const_reverse_iterator { citer (m_list.cbegin ()) };
+      }
+
+      GCH_NODISCARD reference       front (void)       { return *begin ();  }
+      GCH_NODISCARD const_reference front (void) const { return *begin ();  }
+
+      GCH_NODISCARD reference       back  (void)       { return *rbegin (); }
+      GCH_NODISCARD const_reference back  (void) const { return *rbegin (); }
+
+      GCH_NODISCARD
+      bool
+      empty (void) const noexcept
+      {
+        return size () == 0;
+      }
+
+      //! the number of live elements
+      GCH_NODISCARD
+      size_type
+      size (void) const noexcept
+      {
+        return m_list.size () - m_num_dead.load (std::memory_order_acquire);
+      }
+
+      GCH_NODISCARD
+      size_type
+      max_size (void) const noexcept
+      {
+        return m_list.max_size ();
+      }
+
+      GCH_NODISCARD
+      size_type
+      capacity (void) const noexcept
+      {
+        return m_list.capacity ();
+      }
+
+      void
+      reserve (size_type n)
+      {
+        compact ();
+        m_list.reserve (n);
+      }
+
+      //! dead elements are erased first so that their memory may be freed as well
+      void
+      shrink_to_fit (void)
+      {
+        compact ();
+        m_list.shrink_to_fit ();
+      }
+
+      void
+      trim (void) noexcept
+      {
+        compact ();
+        m_list.trim ();
+      }
+
+      //! only available if the underlying storage is indexed
+      GCH_NODISCARD
+      size_type
+      index_of (const const_iterator pos) const noexcept
+      {
+        compact ();
+        return m_list.index_of (pos.base ());
+      }
+
+      template <typename ...Args>
+      iterator
+      emplace (const const_iterator pos, Args&&... args)
+      {
+        return iterator (m_list.emplace (pos.base (), std::forward<Args> (args)...));
+      }
+
+      template <typename InputIt>
+      iterator
+      insert (const const_iterator pos, InputIt first, const InputIt last)
+      {
+        if (first == last)
+          return iterator (m_list.erase (pos.base (), pos.base ()));
+
+        const iterator ret = emplace (pos, *first);
+        try
+        {
+          while (++first != last)
+            emplace (pos, *first);
+        }
+        catch (...)
+        {
+          erase (ret, pos);
+          throw;
+        }
+        return ret;
+      }
+
+      //! `pos` must not be dead
+      iterator
+      erase (const const_iterator pos) noexcept
+      {
+        return iterator (m_list.erase (pos.base ()));
+      }
+
+      //! [first, last) must not contain dead elements
+      iterator
+      erase (const const_iterator first, const const_iterator last) noexcept
+      {
+        return iterator (m_list.erase (first.base (), last.base ()));
+      }
+
+      void
+      clear (void) noexcept
+      {
+        m_list.clear ();
+        m_num_dead.store (0, std::memory_order_relaxed);
+      }
+
+      void
+      splice (const const_iterator pos, tombstone_list& other)
+      {
+        compact ();
+        other.compact ();
+        m_list.splice (pos.base (), other.m_list);
+      }
+
+      void
+      merge (tombstone_list& other)
+      {
+        compact ();
+        other.compact ();
+        m_list.merge (other.m_list);
+      }
+
+      void
+      sort (void)
+      {
+        compact ();
+        m_list.sort ();
+      }
+
+      template <typename Pred>
+      void
+      remove_if (Pred pred)
+      {
+        compact ();
+        m_list.remove_if ([&pred](const node& n) { return pred (n.m_value); });
+      }
+
+      //! marks `pos` as dead; safe to call concurrently with anything but `compact`
+      void
+      kill (const const_iterator pos) const noexcept
+      {
+        // count first so that `compact` never erases more elements than were counted
+        m_num_dead.fetch_add (1, std::memory_order_relaxed);
+        pos.base ()->m_is_dead.store (true);
+      }
+
+      //! visits the live elements without compacting, so that it may run alongside `kill`
+      template <typename Function>
+      void
+      for_each_live (Function f) const
+      {
+        for_each_live (uncompacted_cbegin (), uncompacted_cend (), f);
+      }
+
+      //! as above, within a part of the uncompacted elements
+      template <typename Function>
+      void
+      for_each_live (const_iterator first, const const_iterator last, Function f) const
+      {
+        for (; first != last; ++first)
+        {
+          if (! first.base ()->m_is_dead.load ())
+            f (*first);
+        }
+      }
+
+      //! the bounds of every element, dead or not, for readers which run alongside `kill`
+      GCH_NODISCARD
+      const_iterator
+      uncompacted_cbegin (void) const noexcept
+      {
+        return citer (m_list.cbegin ());
+      }
+
+      GCH_NODISCARD
+      const_iterator
+      uncompacted_cend (void) const noexcept
+      {
+        return citer (m_list.cend ());
+      }
+
+      //! erases the dead elements
+      void
+      compact (void) const noexcept
+      {
+        if (m_num_dead.load (std::memory_order_acquire) == 0)
+          return;
+
+        const size_type prev_size = m_list.size ();
+        m_list.remove_if ([](const node& n)
+                          {
+                            return n.m_is_dead.load (std::memory_order_acquire);
+                          });
+        m_num_dead.fetch_sub (prev_size - m_list.size (), std::memory_order_relaxed);
+      }
+
+    private:
+      static
+      const_iterator
+      citer (typename list_type::const_iterator it) noexcept
+      {
+        return const_iterator (it);
+      }
+
+      // mutable so that dead elements may be reclaimed on const access
+      mutable list_type              m_list;
+      mutable std::atomic<size_type> m_num_dead { 0 };
+    };
+
+  } // namespace gch::detail
+
+  namespace storage
+  {
+
+    // Wraps another storage so that reporters may detach themselves from a
+    // tracker without locking it (see detail::tombstone_list). Costs one extra
+    // byte (usually a word) per reporter. The base storage may not be hashed.
+    template <typename Base = list>
+    struct tombstoned
+    {
+      static_assert (! Base::is_hashed::value, "hashed storage may not be tombstoned");
+      static_assert (! Base::is_compact::value, "compact storage may not be wrapped");
+      static_assert (! Base::is_linked::value, "linked storage may not be wrapped");
+      static_assert (! Base::is_paired::value, "paired storage may not be wrapped");
+      static_assert (! Base::is_sorted::value, "sorted storage may not be tombstoned");
+
+      template <typename T>
+      using container_type = detail::tombstone_list<Base, T>;
+
+      template <typename T>
+      using iterator_type = detail::node_value_iterator<
+        T, typename Base::template iterator_type<detail::tombstone_list_node<T>>>;
+
+      template <typename T>
+      using const_iterator_type = detail::node_value_iterator<
+        T, typename Base::template const_iterator_type<detail::tombstone_list_node<T>>>;
+
+      using is_splice_stable = typename Base::is_splice_stable;
+      using is_indexed       = typename Base::is_indexed;
+      using is_hashed        = std::false_type;
+      using is_tombstoned    = std::true_type;
+      using is_compact       = std::false_type;
+      using is_sorted        = std::false_type;
+      using is_instrumented  = typename Base::is_instrumented;
+      using is_linked        = std::false_type;
+      using is_paired        = std::false_type;
+      using edge_data_type   = typename Base::edge_data_type;
+      using lock_type        = typename Base::lock_type;
+    };
+
+  } // namespace gch::storage
+
+} // namespace gch
+
+#endif // GCH_TRACKER_TOMBSTONE_LIST_HPP
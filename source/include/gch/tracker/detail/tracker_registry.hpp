@@ -0,0 +1,220 @@
+/** tracker_registry.hpp
+ * Copyright © 2021 Gene Harvey
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license. See the LICENSE file for details.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GCH_TRACKER_TRACKER_REGISTRY_HPP
+#define GCH_TRACKER_TRACKER_REGISTRY_HPP
+
+#include "common.hpp"
+#include "concurrent.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace gch
+{
+
+  namespace detail
+  {
+
+    //////////////////////
+    // tracker_registry //
+    //////////////////////
+
+    // Maps 32-bit ids to the trackers of type T which hold them. Id 0 is never
+    // handed out, so that it may stand for null. Lookups don't lock; the table
+    // is made of fixed chunks which are never moved once they are published.
+    // The table of chunks is static (512 KiB of zero pages per T), and each
+    // chunk is allocated on first use.
+    template <typename T>
+    class tracker_registry
+    {
+      static constexpr std::size_t chunk_bits = 16;
+      static constexpr std::size_t chunk_size = std::size_t (1) << chunk_bits;
+      static constexpr std::size_t num_chunks = std::size_t (1) << (32 - chunk_bits);
+
+      struct state
+      {
+        shared_spinlock            m_lock;
+        std::vector<std::uint32_t> m_free_ids;
+        std::uint64_t              m_next_id = 1;
+      };
+
+    public:
+      static
+      std::uint32_t
+      acquire (T *p)
+      {
+        state& s = get_state ();
+        const std::lock_guard<shared_spinlock> guard (s.m_lock);
+
+        std::uint32_t id;
+        if (! s.m_free_ids.empty ())
+        {
+          id = s.m_free_ids.back ();
+          s.m_free_ids.pop_back ();
+        }
+        else
+        {
+          if (s.m_next_id == (std::uint64_t (1) << 32))
+            throw std::length_error ("ran out of tracker ids");
+
+          id = static_cast<std::uint32_t> (s.m_next_id);
+          std::atomic<T **>& chunk = get_chunks ()[id >> chunk_bits];
+          if (chunk.load (std::memory_order_relaxed) == nullptr)
+            chunk.store (new T * [chunk_size], std::memory_order_release);
+
+          // make room to free every id handed out so far, so that release can't throw
+          if (s.m_free_ids.capacity () < s.m_next_id)
+            s.m_free_ids.reserve ((std::max) (2 * s.m_free_ids.capacity (),
+                                              static_cast<std::size_t> (s.m_next_id)));
+          ++s.m_next_id;
+        }
+        slot (id) = p;
+        return id;
+      }
+
+      static
+      void
+      release (std::uint32_t id) noexcept
+      {
+        state& s = get_state ();
+        const std::lock_guard<shared_spinlock> guard (s.m_lock);
+        slot (id) = nullptr;
+        s.m_free_ids.push_back (id);
+      }
+
+      GCH_NODISCARD static
+      T *
+      get (std::uint32_t id) noexcept
+      {
+        return id == 0 ? nullptr : slot (id);
+      }
+
+    private:
+      static
+      T *&
+      slot (std::uint32_t id) noexcept
+      {
+        return get_chunks ()[id >> chunk_bits].load (std::memory_order_acquire)
+                 [id & (chunk_size - 1)];
+      }
+
+      // zero-initialized at load time, so lookups need no guard
+      static
+      std::atomic<T **> *
+      get_chunks (void) noexcept
+      {
+        static std::atomic<T **> chunks[num_chunks];
+        return chunks;
+      }
+
+      // never destroyed, so that trackers with static storage duration may
+      // still release their ids during exit
+      static
+      state&
+      get_state (void)
+      {
+        static state *s = new state;
+        return *s;
+      }
+    };
+
+    //////////////////////////
+    // tracker_registration //
+    //////////////////////////
+
+    // Gives a tracker with compact storage an id for as long as it lives.
+    // Like reporters_lock, a tracker gets a new id when it is moved (the
+    // reporters are pointed at the new tracker anyway). This is empty if
+    // IsCompact is false.
+    template <typename Tracker, typename IsCompact>
+    class tracker_registration
+    { };
+
+    template <typename Tracker>
+    class tracker_registration<Tracker, std::true_type>
+    {
+    public:
+//    tracker_registration            (void)                            = impl;
+//    tracker_registration            (const tracker_registration&)     = impl;
+//    tracker_registration            (tracker_registration&&) noexcept = impl;
+//    tracker_registration& operator= (const tracker_registration&)     = impl;
+//    tracker_registration& operator= (tracker_registration&&) noexcept = impl;
+//    ~tracker_registration           (void)                            = impl;
+
+      tracker_registration (void)
+        : m_id (tracker_registry<Tracker>::acquire (static_cast<Tracker *> (this)))
+      { }
+
+      tracker_registration (const tracker_registration&)
+        : tracker_registration ()
+      { }
+
+      tracker_registration&
+      operator= (const tracker_registration&) noexcept
+      {
+        return *this;
+      }
+
+      ~tracker_registration (void)
+      {
+        tracker_registry<Tracker>::release (m_id);
+      }
+
+      GCH_NODISCARD
+      std::uint32_t
+      get_tracker_id (void) const noexcept
+      {
+        return m_id;
+      }
+
+    private:
+      std::uint32_t m_id;
+    };
+
+    ////////////////////
+    // tracker_id_ptr //
+    ////////////////////
+
+    // A pointer to a tracker with compact storage, stored as the tracker's id.
+    // Converts to and from T * so that it may stand in for one.
+    template <typename T>
+    class tracker_id_ptr
+    {
+    public:
+      tracker_id_ptr            (void)                      = default;
+      tracker_id_ptr            (const tracker_id_ptr&)     = default;
+      tracker_id_ptr            (tracker_id_ptr&&) noexcept = default;
+      tracker_id_ptr& operator= (const tracker_id_ptr&)     = default;
+      tracker_id_ptr& operator= (tracker_id_ptr&&) noexcept = default;
+      ~tracker_id_ptr           (void)                      = default;
+
+      /* implicit */
+      tracker_id_ptr (T *p) noexcept
+        : m_id (p == nullptr ? 0 : p->get_tracker_id ())
+      { }
+
+      /* implicit */
+      operator T * (void) const noexcept
+      {
+        return tracker_registry<T>::get (m_id);
+      }
+
+    private:
+      std::uint32_t m_id = 0;
+    };
+
+  } // namespace gch::detail
+
+} // namespace gch
+
+#endif // GCH_TRACKER_TRACKER_REGISTRY_HPP
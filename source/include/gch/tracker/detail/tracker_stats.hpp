@@ -0,0 +1,389 @@
+/** tracker_stats.hpp
+ * Copyright © 2021 Gene Harvey
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license. See the LICENSE file for details.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef GCH_TRACKER_TRACKER_STATS_HPP
+#define GCH_TRACKER_TRACKER_STATS_HPP
+
+#include "common.hpp"
+#include "concurrent.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace gch
+{
+
+  struct tracker_stats
+  {
+    std::size_t num_binds         = 0; //!< bindings made (track, rebind_remote)
+    std::size_t num_debinds       = 0; //!< bindings erased (debind_remote, detaching, reset)
+    std::size_t num_repoints      = 0; //!< remotes pointed back at a relocated tracker
+    std::size_t num_moves         = 0; //!< reporters moved or swapped while bound
+    std::size_t num_remote_writes = 0; //!< writes to the reporters held by remotes
+    std::size_t num_allocations   = 0; //!< insertions which grew the storage
+  };
+
+  namespace detail
+  {
+
+    enum class tracker_event : std::size_t
+    {
+      bind,
+      debind,
+      repoint,
+      move,
+      remote_write,
+      allocation
+    };
+
+    constexpr std::size_t num_tracker_events = 6;
+
+    // The signature of this function names T. It is parsed by `stats_type_name`.
+    template <typename T>
+    const char *
+    stats_signature (void) noexcept
+    {
+#if defined (__clang__) || defined (__GNUC__)
+      return __PRETTY_FUNCTION__;
+#elif defined (_MSC_VER)
+      return __FUNCSIG__;
+#else
+      return "unknown";
+#endif
+    }
+
+    inline
+    std::string
+    stats_type_name (const char *signature)
+    {
+      const std::string s (signature);
+#if defined (__clang__) || defined (__GNUC__)
+      const std::size_t first = s.find ("T = ");
+      const std::size_t last  = s.rfind (']');
+      if (first != std::string::npos && last != std::string::npos && first + 4 < last)
+        return s.substr (first + 4, last - first - 4);
+#elif defined (_MSC_VER)
+      const std::size_t first = s.find ("stats_signature<");
+      const std::size_t last  = s.rfind (">(void)");
+      if (first != std::string::npos && last != std::string::npos && first + 16 < last)
+        return s.substr (first + 16, last - first - 16);
+#endif
+      return s;
+    }
+
+    ////////////////////////////
+    // tracker_stats_counters //
+    ////////////////////////////
+
+    // The counters of one tracker type. They are only ever added to atomically,
+    // so a snapshot taken while trackers are in use may be slightly torn.
+    class tracker_stats_counters
+    {
+    public:
+      explicit
+      tracker_stats_counters (std::string name)
+        : m_name (std::move (name))
+      {
+        for (std::atomic<std::size_t>& c : m_counts)
+          c.store (0, std::memory_order_relaxed);
+      }
+
+      void
+      add (tracker_event e, std::size_t n) noexcept
+      {
+        m_counts[static_cast<std::size_t> (e)].fetch_add (n, std::memory_order_relaxed);
+      }
+
+      GCH_NODISCARD
+      const std::string&
+      get_name (void) const noexcept
+      {
+        return m_name;
+      }
+
+      GCH_NODISCARD
+      tracker_stats
+      get_stats (void) const noexcept
+      {
+        tracker_stats ret;
+        ret.num_binds         = load (tracker_event::bind);
+        ret.num_debinds       = load (tracker_event::debind);
+        ret.num_repoints      = load (tracker_event::repoint);
+        ret.num_moves         = load (tracker_event::move);
+        ret.num_remote_writes = load (tracker_event::remote_write);
+        ret.num_allocations   = load (tracker_event::allocation);
+        return ret;
+      }
+
+      void
+      reset (void) noexcept
+      {
+        for (std::atomic<std::size_t>& c : m_counts)
+          c.store (0, std::memory_order_relaxed);
+      }
+
+    private:
+      GCH_NODISCARD
+      std::size_t
+      load (tracker_event e) const noexcept
+      {
+        return m_counts[static_cast<std::size_t> (e)].load (std::memory_order_relaxed);
+      }
+
+      const std::string        m_name;
+      std::atomic<std::size_t> m_counts[num_tracker_events];
+    };
+
+    ////////////////////////////
+    // tracker_stats_registry //
+    ////////////////////////////
+
+    // The counters of every instrumented tracker type which has been used.
+    class tracker_stats_registry
+    {
+    public:
+      // never destroyed, so that trackers with static storage duration may
+      // still be counted during exit
+      static
+      tracker_stats_registry&
+      get (void)
+      {
+        static tracker_stats_registry *r = new tracker_stats_registry;
+        return *r;
+      }
+
+      void
+      add (tracker_stats_counters& c)
+      {
+        const std::lock_guard<shared_spinlock> guard (m_lock);
+        m_counters.push_back (&c);
+      }
+
+      void
+      reset (void) noexcept
+      {
+        const std::lock_guard<shared_spinlock> guard (m_lock);
+        for (tracker_stats_counters *c : m_counters)
+          c->reset ();
+      }
+
+      //! one line per tracker type
+      void
+      write_text (std::ostream& os) const
+      {
+        const std::lock_guard<shared_spinlock> guard (m_lock);
+        for (const tracker_stats_counters *c : m_counters)
+        {
+          const tracker_stats s = c->get_stats ();
+          os << c->get_name ()
+             << ": binds="         << s.num_binds
+             << " debinds="        << s.num_debinds
+             << " repoints="       << s.num_repoints
+             << " moves="          << s.num_moves
+             << " remote_writes="  << s.num_remote_writes
+             << " allocations="    << s.num_allocations
+             << '\n';
+        }
+      }
+
+      //! an array with an object per tracker type
+      void
+      write_json (std::ostream& os) const
+      {
+        const std::lock_guard<shared_spinlock> guard (m_lock);
+        os << '[';
+        const char *sep = "";
+        for (const tracker_stats_counters *c : m_counters)
+        {
+          const tracker_stats s = c->get_stats ();
+          os << sep << "{\"type\":\"";
+          write_json_string (os, c->get_name ());
+          os << "\",\"binds\":"         << s.num_binds
+             << ",\"debinds\":"         << s.num_debinds
+             << ",\"repoints\":"        << s.num_repoints
+             << ",\"moves\":"           << s.num_moves
+             << ",\"remote_writes\":"   << s.num_remote_writes
+             << ",\"allocations\":"     << s.num_allocations
+             << '}';
+          sep = ",";
+        }
+        os << "]\n";
+      }
+
+    private:
+      tracker_stats_registry (void) = default;
+
+      static
+      void
+      write_json_string (std::ostream& os, const std::string& str)
+      {
+        for (const char ch : str)
+        {
+          if (ch == '"' || ch == '\\')
+            os << '\\';
+          os << ch;
+        }
+      }
+
+      mutable shared_spinlock               m_lock;
+      std::vector<tracker_stats_counters *> m_counters;
+    };
+
+    ////////////////////////
+    // tracker_stats_hook //
+    ////////////////////////
+
+    // Where trackers report what they do. This is empty, and every call to it
+    // compiles away, if IsInstrumented is false.
+    template <typename Tracker, typename IsInstrumented>
+    struct tracker_stats_hook
+    {
+      static
+      void
+      count (tracker_event, std::size_t = 1) noexcept
+      { }
+
+      template <typename Container>
+      static constexpr
+      std::size_t
+      capacity_of (const Container&) noexcept
+      {
+        return 0;
+      }
+
+      template <typename Container>
+      static
+      void
+      count_growth (const Container&, std::size_t) noexcept
+      { }
+    };
+
+    template <typename Tracker>
+    struct tracker_stats_hook<Tracker, std::true_type>
+    {
+      static
+      void
+      count (tracker_event e, std::size_t n = 1) noexcept
+      {
+        get_counters ().add (e, n);
+      }
+
+      //! to be passed to `count_growth` after an insertion
+      template <typename Container>
+      static
+      std::size_t
+      capacity_of (const Container& c) noexcept
+      {
+        return c.capacity ();
+      }
+
+      template <typename Container>
+      static
+      void
+      count_growth (const Container& c, std::size_t prev_capacity) noexcept
+      {
+        if (prev_capacity < c.capacity ())
+          count (tracker_event::allocation);
+      }
+
+      static
+      tracker_stats_counters&
+      get_counters (void)
+      {
+        static tracker_stats_counters *c = make_counters ();
+        return *c;
+      }
+
+    private:
+      static
+      tracker_stats_counters *
+      make_counters (void)
+      {
+        auto *c = new tracker_stats_counters (stats_type_name (stats_signature<Tracker> ()));
+        tracker_stats_registry::get ().add (*c);
+        return c;
+      }
+    };
+
+  } // namespace gch::detail
+
+  //! the counts of `Tracker`, whose storage must be instrumented
+  template <typename Tracker>
+  GCH_NODISCARD
+  tracker_stats
+  get_tracker_stats (void)
+  {
+    using base_type = typename tracker_traits<Tracker>::local_base_type;
+    return base_type::stats_hook::get_counters ().get_stats ();
+  }
+
+  //! zeroes the counts of every instrumented tracker type
+  inline
+  void
+  reset_tracker_stats (void) noexcept
+  {
+    detail::tracker_stats_registry::get ().reset ();
+  }
+
+  //! writes the counts of every instrumented tracker type which has been used, one per line
+  inline
+  void
+  write_tracker_stats (std::ostream& os)
+  {
+    detail::tracker_stats_registry::get ().write_text (os);
+  }
+
+  //! as above, as a JSON array of objects
+  inline
+  void
+  write_tracker_stats_json (std::ostream& os)
+  {
+    detail::tracker_stats_registry::get ().write_json (os);
+  }
+
+  namespace storage
+  {
+
+    // Wraps another storage so that its trackers count what they do (see
+    // gch::tracker_stats). The counts are kept per tracker type in relaxed
+    // atomics, and may be written out with `write_tracker_stats`. Without this
+    // wrapper, the counting compiles away entirely.
+    template <typename Base = list>
+    struct instrumented
+    {
+      template <typename T>
+      using container_type = typename Base::template container_type<T>;
+
+      template <typename T>
+      using iterator_type = typename Base::template iterator_type<T>;
+
+      template <typename T>
+      using const_iterator_type = typename Base::template const_iterator_type<T>;
+
+      using is_splice_stable = typename Base::is_splice_stable;
+      using is_indexed       = typename Base::is_indexed;
+      using is_hashed        = typename Base::is_hashed;
+      using is_tombstoned    = typename Base::is_tombstoned;
+      using is_compact       = typename Base::is_compact;
+      using is_sorted        = typename Base::is_sorted;
+      using is_instrumented  = std::true_type;
+      using is_linked        = typename Base::is_linked;
+      using is_paired        = typename Base::is_paired;
+      using edge_data_type   = typename Base::edge_data_type;
+      using lock_type        = typename Base::lock_type;
+    };
+
+  } // namespace gch::storage
+
+} // namespace gch
+
+#endif // GCH_TRACKER_TRACKER_STATS_HPP
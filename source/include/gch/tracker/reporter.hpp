@@ -9,6 +9,14 @@
 #define GCH_TRACKER_REPORTER_HPP
 
 #include "detail/common.hpp"
+#include "detail/linked_list.hpp"
+#include "detail/tracker_registry.hpp"
+#include "detail/tracker_stats.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
 
 namespace gch
 {
@@ -65,6 +73,110 @@ namespace gch
   namespace detail
   {
 
+    // What a reporter keeps to find its remote. Reporters bound to a tracker
+    // with compact storage keep the id of the tracker (see storage::compact).
+    template <typename Derived, typename RemoteBase>
+    struct remote_base_holder
+    {
+      using type = RemoteBase *;
+    };
+
+    template <typename LocalBaseTag, typename Storage, typename RemoteBase>
+    struct remote_base_holder<reporter_base<LocalBaseTag, tag::basic_tracker_base<Storage>>,
+                              RemoteBase>
+    {
+      using type = typename std::conditional<Storage::is_compact::value,
+                                             tracker_id_ptr<RemoteBase>,
+                                             RemoteBase *>::type;
+    };
+
+    // With linked storage, a reporter keeps the node which its remote tracker
+    // links it by (see storage::linked).
+    template <typename RemoteReporter, bool IsLinked>
+    class reporter_link
+    { };
+
+    template <typename RemoteReporter>
+    class reporter_link<RemoteReporter, true>
+    {
+    public:
+      using link_type = linked_node<RemoteReporter>;
+
+      GCH_NODISCARD
+      link_type&
+      get_link (void) noexcept
+      {
+        return m_link;
+      }
+
+    protected:
+      void
+      swap_link (reporter_link& other) noexcept
+      {
+        using std::swap;
+        swap (m_link, other.m_link);
+      }
+
+    private:
+      link_type m_link;
+    };
+
+    // What a tracker keeps alongside each of its reporters (see
+    // storage::with_edge_data). Reporters themselves keep nothing.
+    template <typename LocalBaseTag>
+    struct edge_data_of
+    {
+      using type = void;
+    };
+
+    template <typename Storage>
+    struct edge_data_of<tag::basic_tracker_base<Storage>>
+    {
+      using type = typename Storage::edge_data_type;
+    };
+
+    template <typename EdgeData>
+    class reporter_edge
+    {
+    public:
+      using edge_data_type = EdgeData;
+
+      GCH_NODISCARD GCH_CPP14_CONSTEXPR
+      edge_data_type&
+      get_edge (void) noexcept
+      {
+        return m_edge;
+      }
+
+      GCH_NODISCARD constexpr
+      const edge_data_type&
+      get_edge (void) const noexcept
+      {
+        return m_edge;
+      }
+
+    protected:
+      void
+      swap_edge (reporter_edge& other) noexcept
+      {
+        using std::swap;
+        swap (m_edge, other.m_edge);
+      }
+
+    private:
+      edge_data_type m_edge { };
+    };
+
+    template <>
+    class reporter_edge<void>
+    {
+    protected:
+      static
+      void
+      swap_edge (reporter_edge&) noexcept
+      { }
+    };
+
     template <typename Derived, typename RemoteBase>
     class reporter_base_common
     {
@@ -160,7 +272,7 @@ namespace gch
       }
 
     private:
-      remote_base_ptr m_remote_base { nullptr };
+      typename remote_base_holder<Derived, RemoteBase>::type m_remote_base { nullptr };
     };
 
     template <typename Derived, typename RemoteBase>
@@ -342,7 +454,8 @@ namespace gch
     template <typename LocalBaseTag>
     class reporter_base<LocalBaseTag, tag::reporter_base>
       : public reporter_base_common<reporter_base<LocalBaseTag, tag::reporter_base>,
-                                    reporter_base<tag::reporter_base, LocalBaseTag>>
+                                    reporter_base<tag::reporter_base, LocalBaseTag>>,
+        public reporter_edge<typename edge_data_of<LocalBaseTag>::type>
     {
       using traits = tracker_traits<reporter_base<LocalBaseTag, tag::reporter_base>>;
     public:
@@ -432,15 +545,35 @@ namespace gch
         base::track (remote);
         return *this;
       }
+
+      //! points the remote back at *this after *this has been relocated
+      void
+      repoint_remote (void) noexcept
+      {
+        get_remote_reporter ().track (*this);
+      }
+
+      //! with linked storage, the node of *this, which is kept by the remote
+      template <typename RemoteBase = remote_base_type>
+      GCH_NODISCARD
+      auto
+      get_link (void) const noexcept
+        -> decltype (std::declval<RemoteBase&> ().get_link ())
+      {
+        return base::get_remote_base ().get_link ();
+      }
     };
 
     // with remote tracker
-    template <typename LocalBaseTag>
-    class reporter_base<LocalBaseTag, tag::tracker_base>
-      : public reporter_base_common<reporter_base<LocalBaseTag, tag::tracker_base>,
-                                    tracker_base<LocalBaseTag>>
+    template <typename LocalBaseTag, typename Storage>
+    class reporter_base<LocalBaseTag, tag::basic_tracker_base<Storage>>
+      : public reporter_base_common<reporter_base<LocalBaseTag, tag::basic_tracker_base<Storage>>,
+                                    tracker_base<LocalBaseTag, Storage>>,
+        public reporter_link<reporter_base<tag::basic_tracker_base<Storage>, LocalBaseTag>,
+                             Storage::is_linked::value>,
+        public reporter_edge<typename edge_data_of<LocalBaseTag>::type>
     {
-      using traits = tracker_traits<reporter_base<LocalBaseTag, tag::tracker_base>>;
+      using traits = tracker_traits<reporter_base<LocalBaseTag, tag::basic_tracker_base<Storage>>>;
     public:
 
       using local_base_tag  = typename traits::local_base_tag;
@@ -459,7 +592,9 @@ namespace gch
       using remote_base_type = typename traits::remote_base_type;
 
     private:
-      using base = reporter_base_common<reporter_base, remote_base_type>;
+      using base      = reporter_base_common<reporter_base, remote_base_type>;
+      using link_base = reporter_link<remote_reporter_type, Storage::is_linked::value>;
+      using edge_base = reporter_edge<typename edge_data_of<LocalBaseTag>::type>;
 
     public:
       using base::base;
@@ -475,18 +610,18 @@ namespace gch
 
       reporter_base (gch::tag::bind_t, remote_base_type& remote)
         : base   (tag::track, remote),
-          m_self (remote.track (remote.find_sorted_pos (*this), *this))
+          m_self (to_self (remote.track_sorted (*this)))
       { }
 
       reporter_base (gch::tag::bind_t, remote_base_type& remote, remote_const_access_type pos)
         : base   (tag::track, remote),
-          m_self (remote.track (pos, *this))
+          m_self (to_self (remote.track (pos, *this)))
       { }
 
       constexpr
       reporter_base (remote_base_type& remote, remote_access_type it) noexcept
         : base   (tag::track, remote),
-          m_self (it)
+          m_self (to_self (it))
       { }
 
       // remote asymmetric debind
@@ -495,7 +630,7 @@ namespace gch
       reset_remote_tracking (void) const noexcept
       {
         if (base::is_tracked ())
-          base::get_remote_base ().rptrs_erase (m_self);
+          base::get_remote_base ().detach_reporter (get_self ());
       }
 
       GCH_NODISCARD
@@ -504,7 +639,7 @@ namespace gch
       {
         if (! base::is_tracked ())
           return 0;
-        return static_cast<std::size_t> (base::get_remote_base ().get_reporter_offset (m_self));
+        return static_cast<std::size_t> (base::get_remote_base ().get_reporter_offset (get_self ()));
       }
 
       reporter_base&
@@ -513,21 +648,13 @@ namespace gch
         // if the remotes are the same then this is already in the remote,
         // so we shouldn't do anything unless we aren't being tracked right now.
         if (! base::is_tracking (new_remote))
-        {
-          // might throw
-          remote_access_type new_iter = new_remote.track (new_remote.rptrs_cend (), *this);
-
-          // if we didn't throw the rest is noexcept
-          reset_remote_tracking ();
-          base::track (new_remote);
-          m_self = new_iter;
-        }
+          rebind (new_remote, typename Storage::is_linked { });
         else if (! base::is_tracked ())
         {
           // we already point to new_remote, but we aren't tracked
           // note that that the above condition implies that has_remote () == true
           // since &new_remote cannot be nullptr.
-          m_self = new_remote.track (new_remote.rptrs_cend (), *this);
+          m_self = to_self (new_remote.track (new_remote.rptrs_cend (), *this));
         }
         return *this;
       }
@@ -540,20 +667,22 @@ namespace gch
 
         using std::swap;
         swap (this->m_self, other.m_self);
+        swap_link (other, typename Storage::is_linked { });
+        edge_base::swap_edge (other);
       }
 
       GCH_NODISCARD constexpr
       remote_reporter_type&
       get_remote_reporter (void) const noexcept
       {
-        return *m_self;
+        return *get_self ();
       }
 
       GCH_NODISCARD constexpr
       const remote_reporter_type&
       get_const_remote_reporter (void) const noexcept
       {
-        return *m_self;
+        return *get_self ();
       }
 
   //  protected:
@@ -569,19 +698,98 @@ namespace gch
       set (remote_base_type& remote, remote_access_type it) noexcept
       {
         base::track (remote);
-        m_self = it;
+        m_self = to_self (it);
         return *this;
       }
 
       reporter_base&
       set_access (remote_access_type it) noexcept
       {
-        m_self = it;
+        m_self = to_self (it);
         return *this;
       }
 
+      //! points the remote back at *this after *this has been relocated
+      void
+      repoint_remote (void) noexcept
+      {
+        remote_base_type::stats_hook::count (tracker_event::move);
+        repoint_remote (typename Storage::is_linked { });
+      }
+
     private:
-      remote_access_type m_self;
+      void
+      rebind (remote_base_type& new_remote, std::false_type)
+      {
+        // might throw
+        remote_access_type new_iter = new_remote.track (new_remote.rptrs_cend (), *this);
+
+        // if we didn't throw the rest is noexcept
+        reset_remote_tracking ();
+        base::track (new_remote);
+        m_self = to_self (new_iter);
+      }
+
+      // the node of *this has to leave the old remote before it can join the new one
+      template <typename Linked = std::true_type>
+      void
+      rebind (remote_base_type& new_remote, Linked) noexcept
+      {
+        reset_remote_tracking ();
+        base::track (new_remote);
+        m_self = to_self (new_remote.track (new_remote.rptrs_cend (), *this));
+      }
+
+      static
+      void
+      swap_link (reporter_base&, std::false_type) noexcept
+      { }
+
+      template <typename Linked = std::true_type>
+      void
+      swap_link (reporter_base& other, Linked) noexcept
+      {
+        link_base::swap_link (other);
+      }
+
+      void
+      repoint_remote (std::false_type) noexcept
+      {
+        base::get_remote_base ().modify_reporter (*get_self (), [this](remote_reporter_type& r)
+                                                                {
+                                                                  r.track (*this);
+                                                                });
+      }
+
+      // the node came along with *this, so its neighbors are pointed back at it
+      template <typename Linked = std::true_type>
+      void
+      repoint_remote (Linked) noexcept
+      {
+        m_self = to_self (base::get_remote_base ().relink_reporter (
+          link_base::get_link (), [this](remote_reporter_type& r) { r.track (*this); }));
+      }
+
+      // with compact storage, a slot index in the remote rather than an iterator
+      using self_type = typename std::conditional<Storage::is_compact::value,
+                                                  std::uint32_t,
+                                                  remote_access_type>::type;
+
+      static constexpr
+      self_type
+      to_self (remote_access_type it) noexcept
+      {
+        return remote_base_type::rptrs_handle_of (it);
+      }
+
+      GCH_NODISCARD constexpr
+      remote_access_type
+      get_self (void) const noexcept
+      {
+        return base::get_remote_base ().rptrs_at (m_self);
+      }
+
+      self_type m_self;
     };
 
     template <typename Interface>
@@ -656,7 +864,7 @@ namespace gch
         : base (other) // the base is trivially copyable
       {
         if (has_remote ())
-          base::get_remote_reporter ().track (*this);
+          base::repoint_remote ();
         other.wipe ();
       }
 
@@ -669,7 +877,7 @@ namespace gch
           if (other.is_tracked ())
           {
             base::operator= (other); // the base is trivially copyable
-            base::get_remote_reporter ().track (*this);
+            base::repoint_remote ();
             other.wipe ();
           }
           else
@@ -704,10 +912,10 @@ namespace gch
           base::swap (other);
 
           if (this->is_tracked ())
-            this->get_remote_reporter ().track (*this);
+            this->repoint_remote ();
 
           if (other.is_tracked ())
-            other.get_remote_reporter ().track (other);
+            other.repoint_remote ();
         }
       }
 
@@ -733,7 +941,7 @@ namespace gch
         if (&other != this)
         {
           if (other.is_tracked ())
-            base::rebind (other.get_remote_base ());
+            rebind (other.get_remote_interface ());
           else
             base::debind ();
         }
@@ -793,10 +1001,37 @@ namespace gch
         return static_cast<remote_interface_type&> (base::get_remote_base ());
       }
 
+      //! the data which the remote tracker keeps about this binding (see storage::with_edge_data)
+      template <typename Base = base>
+      GCH_NODISCARD constexpr
+      auto
+      get_edge (void) const noexcept
+        -> decltype (std::declval<Base&> ().get_remote_reporter ().get_edge ())
+      {
+        return base::get_remote_reporter ().get_edge ();
+      }
+
+      //! tells the parents of the old and new remotes, if they have hooks (see has_debind_hook)
       local_interface_type&
       rebind (remote_interface_type& new_remote)
       {
-        return static_cast<local_interface_type&> (base::rebind (new_remote));
+        if (! has_remote (new_remote))
+        {
+          remote_interface_type *old_remote = has_remote () ? &get_remote_interface () : nullptr;
+          base::rebind (new_remote);
+          if (old_remote)
+            notify_debind (*old_remote);
+          notify_rebind (new_remote);
+        }
+        return static_cast<local_interface_type&> (*this);
+      }
+
+      //! hints that the remote is about to be repointed (i.e. that *this is about to be moved)
+      void
+      prefetch_remote (void) const noexcept
+      {
+        if (has_remote ())
+          prefetch_for_write (&base::get_remote_reporter ());
       }
 
     private:
@@ -918,6 +1153,35 @@ namespace gch
 
   }
 
+  //! Moves the reporters in [first, last) into the uninitialized storage at
+  //! `d_first`, and destroys the originals. Moving a reporter writes to its
+  //! remote, so the remotes are prefetched a batch at a time to overlap those
+  //! writes rather than waiting on each one in turn. Returns the end of the
+  //! destination range.
+  template <typename ForwardIt, typename NoThrowForwardIt>
+  NoThrowForwardIt
+  relocate_reporters (ForwardIt first, const ForwardIt last, NoThrowForwardIt d_first) noexcept
+  {
+    using value_type = typename std::iterator_traits<ForwardIt>::value_type;
+    static_assert (std::is_nothrow_move_constructible<value_type>::value,
+                   "reporters must be nothrow move constructible to be relocated");
+
+    constexpr std::size_t batch_size = 16;
+    while (first != last)
+    {
+      std::size_t n = 0;
+      for (ForwardIt it = first; it != last && n != batch_size; ++it, ++n)
+        it->prefetch_remote ();
+
+      for (; n != 0; --n, ++first, ++d_first)
+      {
+        ::new (static_cast<void *> (std::addressof (*d_first))) value_type (std::move (*first));
+        first->~value_type ();
+      }
+    }
+    return d_first;
+  }
+
 }
 
 #endif // TRACKER_REPORTER_HPP
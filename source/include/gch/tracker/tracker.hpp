@@ -11,15 +11,28 @@
 #define GCH_TRACKER_TRACKER_HPP
 
 #include "detail/common.hpp"
+#include "detail/concurrent.hpp"
+#include "detail/hashed_list.hpp"
+#include "detail/indexed_list.hpp"
+#include "detail/linked_list.hpp"
+#include "detail/node_pool.hpp"
+#include "detail/paired_list.hpp"
+#include "detail/parallel.hpp"
+#include "detail/slot_list.hpp"
+#include "detail/small_list.hpp"
+#include "detail/sorted_list.hpp"
+#include "detail/tombstone_list.hpp"
+#include "detail/tracker_registry.hpp"
+#include "detail/tracker_stats.hpp"
 #include "reporter.hpp"
 
 namespace gch
 {
 
-  template <typename RemoteBaseTag>
-  struct tracker_traits<detail::tracker_base<RemoteBaseTag>>
+  template <typename RemoteBaseTag, typename Storage>
+  struct tracker_traits<detail::tracker_base<RemoteBaseTag, Storage>>
   {
-    using local_base_tag  = detail::tag::tracker_base;
+    using local_base_tag  = detail::tag::basic_tracker_base<Storage>;
     using remote_base_tag = RemoteBaseTag;
 
     using local_reporter_type  = typename local_base_tag::template reporter_type<local_base_tag,
@@ -69,10 +82,18 @@ namespace gch
   namespace detail
   {
 
-    template <typename RemoteBaseTag>
+    template <typename RemoteBaseTag, typename Storage>
     class tracker_base
+      : private reporters_lock<typename Storage::lock_type>,
+        public  tracker_registration<tracker_base<RemoteBaseTag, Storage>,
+                                     typename Storage::is_compact>
     {
-      using traits = tracker_traits<tracker_base<RemoteBaseTag>>;
+      using traits = tracker_traits<tracker_base<RemoteBaseTag, Storage>>;
+      using lock_base = reporters_lock<typename Storage::lock_type>;
+
+      template <typename, typename>
+      friend class tracker_base;
+
     public:
 
       using local_base_tag  = typename traits::local_base_tag;
@@ -92,7 +113,7 @@ namespace gch
 
     protected:
       // Store pointers to the base types. Downcast when needed.
-      using reporter_list  = tracker_container<local_reporter_type>;
+      using reporter_list  = tracker_container<Storage, local_reporter_type>;
       using rptrs_iter     = typename reporter_list::iterator;
       using rptrs_citer    = typename reporter_list::const_iterator;
       using rptrs_riter    = typename reporter_list::reverse_iterator;
@@ -103,7 +124,40 @@ namespace gch
       using rptrs_diff_ty  = typename reporter_list::difference_type;
       using rptrs_alloc_t  = typename reporter_list::allocator_type;
 
+      using rptrs_alloc_traits = std::allocator_traits<rptrs_alloc_t>;
+
+      // hashed and sorted storage keep an index of the reporters by remote
+      using is_keyed = std::integral_constant<bool, Storage::is_hashed::value
+                                                 || Storage::is_sorted::value>;
+
+      static_assert (! (Storage::is_linked::value && tag::is_tracker_base<RemoteBaseTag>::value),
+                     "linked storage may only be used to track reporters");
+      static_assert (! Storage::is_paired::value || tag::is_tracker_base<RemoteBaseTag>::value,
+                     "paired storage may only be used to track trackers");
+
+      // linked and paired storage do not own their nodes on their own, so
+      // reporters are moved between them by relinking the nodes, not by copying
+      using relinks_nodes = std::integral_constant<bool, Storage::is_linked::value
+                                                      || Storage::is_paired::value>;
+
+    public:
+      // what the remotes keep to find their reporters in *this
+      using rptrs_handle = typename std::conditional<Storage::is_compact::value,
+                                                     std::uint32_t, rptrs_iter>::type;
+
+      // counts what *this does if the storage is instrumented, and nothing otherwise
+      using stats_hook = tracker_stats_hook<tracker_base, typename Storage::is_instrumented>;
+
+    protected:
+
+      using guard_type = reporters_guard<tracker_base>;
+
     public:
+      using lock_base::lock_reporters;
+      using lock_base::unlock_reporters;
+      using lock_base::lock_shared_reporters;
+      using lock_base::unlock_shared_reporters;
+
       tracker_base            (void)                    = default;
       tracker_base            (const tracker_base&)     = delete;
 //    tracker_base            (tracker_base&&) noexcept = impl;
@@ -112,6 +166,7 @@ namespace gch
       ~tracker_base           (void)                    = default;
 
       tracker_base (tracker_base&& other) noexcept
+        : m_rptrs (other.m_rptrs.get_allocator ())
       {
         splice_reporters (rptrs_cend (), other);
       }
@@ -121,11 +176,16 @@ namespace gch
       {
         // clear is noexcept, so it's be safe to do that first
         reset ();
-        m_rptrs = std::move (other.m_rptrs);
-        repoint_reporters (rptrs_begin (), rptrs_end ());
+        move_reporters (other, typename rptrs_alloc_traits::
+                                 propagate_on_container_move_assignment { });
         return *this;
       }
 
+      explicit
+      tracker_base (const rptrs_alloc_t& alloc)
+        : m_rptrs (alloc)
+      { }
+
       tracker_base (const rptrs_citer first, const rptrs_citer last)
       {
         rebind_remote (rptrs_cend (), first, last);
@@ -140,11 +200,47 @@ namespace gch
 
       void
       reset (void) noexcept
+      {
+        reset (ignore_debind { });
+      }
+
+      //! as above, calling `notify` with each remote once it has been debound
+      template <typename Notify>
+      void
+      reset (Notify notify) noexcept
       {
         if (! m_rptrs.empty ())
         {
+          stats_hook::count (tracker_event::debind, m_rptrs.size ());
+          stats_hook::count (tracker_event::remote_write, m_rptrs.size ());
           for (local_reporter_type& p : m_rptrs)
+          {
             p.reset_remote_tracking ();
+            notify (p.get_remote_base ());
+          }
+          m_rptrs.clear ();
+        }
+      }
+
+      //! as above, without writing to the remotes for which `is_dying` is true
+      //! (unsafe unless those are about to be wiped or reset in the same way)
+      template <typename Pred, typename Notify>
+      void
+      reset_external (Pred is_dying, Notify notify) noexcept
+      {
+        if (! m_rptrs.empty ())
+        {
+          stats_hook::count (tracker_event::debind, m_rptrs.size ());
+          for (local_reporter_type& p : m_rptrs)
+          {
+            remote_base_type& remote = p.get_remote_base ();
+            if (! is_dying (remote))
+            {
+              stats_hook::count (tracker_event::remote_write);
+              p.reset_remote_tracking ();
+              notify (remote);
+            }
+          }
           m_rptrs.clear ();
         }
       }
@@ -153,32 +249,43 @@ namespace gch
       swap (tracker_base& other) noexcept
       {
         // kinda expensive
-        m_rptrs.swap (other.m_rptrs);
-        this->repoint_reporters (this->rptrs_begin (), this->rptrs_end ());
-        other.repoint_reporters (other.rptrs_begin (), other.rptrs_end ());
+        // Go through moves so that bindings between `*this` and `other` (which
+        // each need to be repointed from both ends) are kept consistent.
+        tracker_base tmp (std::move (other));
+        other = std::move (*this);
+        *this = std::move (tmp);
+      }
+
+      GCH_NODISCARD
+      rptrs_alloc_t
+      rptrs_get_allocator (void) const noexcept
+      {
+        return m_rptrs.get_allocator ();
+      }
+
+      //! whether the nodes of `other` may be spliced into *this
+      GCH_NODISCARD
+      bool
+      rptrs_alloc_equal (const tracker_base& other) const noexcept
+      {
+        return m_rptrs.get_allocator () == other.m_rptrs.get_allocator ();
       }
 
       rptrs_iter
       splice_reporters (const rptrs_citer pos, tracker_base& src)
       {
-        rptrs_iter pivot = src.rptrs_begin ();
-        // splice is unsafe
-        m_rptrs.splice (pos, src.m_rptrs);
-        // repoint_reporters is safe
-        repoint_reporters (rptrs_begin (), rptrs_end ());
-        return pivot;
+        if (! rptrs_alloc_equal (src))
+          return transfer_reporters (pos, src, src.rptrs_cbegin (), src.rptrs_cend ());
+        return splice_reporters (pos, src, typename Storage::is_sorted { });
       }
 
+      //! with sorted storage, `pos` is ignored and the reporters go to their sorted positions
       rptrs_iter
       transfer_reporters (const rptrs_citer pos, tracker_base& other,
                           const rptrs_citer other_first, const rptrs_citer other_last)
       {
-        rptrs_iter ret = m_rptrs.insert (pos, other_first, other_last);
-        std::for_each (rptrs_citer { ret }, pos, [this, ret](const local_reporter_type& r) {
-          r.get_remote_reporter ().set (*this, ret);
-        });
-        other.m_rptrs.erase (other_first, other_last);
-        return ret;
+        return transfer_reporters (pos, other, other_first, other_last,
+                                   typename Storage::is_sorted { });
       }
 
       GCH_NODISCARD rptrs_iter   rptrs_begin   (void)       noexcept { return m_rptrs.begin ();   }
@@ -203,235 +310,1065 @@ namespace gch
       GCH_NODISCARD rptrs_ref    rptrs_back    (void)                { return m_rptrs.back ();    }
       GCH_NODISCARD rptrs_cref   rptrs_back    (void) const          { return m_rptrs.back ();    }
 
-      GCH_NODISCARD
-      bool rptrs_empty (void) const noexcept
+      GCH_NODISCARD
+      bool rptrs_empty (void) const noexcept
+      {
+        return m_rptrs.empty ();
+      }
+
+      GCH_NODISCARD
+      rptrs_size_ty
+      rptrs_size (void) const noexcept
+      {
+        return m_rptrs.size ();
+      }
+
+      GCH_NODISCARD
+      rptrs_size_ty
+      rptrs_max_size (void) const noexcept
+      {
+        return m_rptrs.max_size ();
+      }
+
+      GCH_NODISCARD
+      rptrs_size_ty
+      rptrs_capacity (void) const noexcept
+      {
+        return m_rptrs.capacity ();
+      }
+
+      void
+      rptrs_reserve (rptrs_size_ty n)
+      {
+        const guard_type guard (*this);
+        m_rptrs.reserve (n);
+      }
+
+      //! safe; the reporters may be relocated, so their remotes are repointed
+      void
+      rptrs_shrink_to_fit (void)
+      {
+        {
+          const guard_type guard (*this);
+          m_rptrs.shrink_to_fit ();
+        }
+        reseat_reporters (rptrs_begin (), rptrs_end ());
+      }
+
+      void
+      rptrs_trim (void) noexcept
+      {
+        const guard_type guard (*this);
+        m_rptrs.trim ();
+      }
+
+      template <typename ...Args>
+      rptrs_iter
+      rptrs_emplace (rptrs_citer pos, Args&&... args)
+      {
+        const guard_type guard (*this);
+        return emplace_reporter (pos, std::forward<Args> (args)...);
+      }
+
+      template <typename ...Args>
+      rptrs_iter
+      rptrs_erase (Args&&... args) noexcept
+      {
+        const guard_type guard (*this);
+        return m_rptrs.erase (std::forward<Args> (args)...);
+      }
+
+      //! erases `pos`, or with a tombstoned storage marks it as dead without locking
+      void
+      detach_reporter (rptrs_citer pos) noexcept
+      {
+        stats_hook::count (tracker_event::debind);
+        detach_reporter (pos, typename Storage::is_tombstoned { });
+      }
+
+      //! erases the reporters which were detached without being erased
+      void
+      compact_reporters (void) noexcept
+      {
+        compact_reporters (typename Storage::is_tombstoned { });
+      }
+
+      //! calls `f` on each reporter while holding the lock shared
+      template <typename Function>
+      void
+      for_each_reporter (Function f) const
+      {
+        const reporters_shared_guard<tracker_base> guard (*this);
+        for_each_reporter (f, typename Storage::is_tombstoned { });
+      }
+
+      //! as above, with the reporters split into runs among tasks (see parallel_for_each_chunk)
+      template <typename Function, typename Executor>
+      void
+      parallel_for_each_reporter (Function f, Executor& executor, std::size_t num_tasks) const
+      {
+        const reporters_shared_guard<tracker_base> guard (*this);
+        parallel_for_each_reporter (f, executor, num_tasks, typename Storage::is_tombstoned { });
+      }
+
+      //! Calls `f (first, n, stride)` on each run of reporters which lie `stride` bytes
+      //! apart, in order, while holding the lock shared.
+      template <typename Function>
+      void
+      for_each_reporter_run (Function f) const
+      {
+        const local_reporter_type *first = nullptr;
+        std::size_t    n      = 0;
+        std::ptrdiff_t stride = 0;
+
+        for_each_reporter ([&](const local_reporter_type& e)
+                           {
+                             if (n != 0)
+                             {
+                               const std::ptrdiff_t d = static_cast<std::ptrdiff_t> (
+                                   reinterpret_cast<std::uintptr_t> (&e)
+                                 - reinterpret_cast<std::uintptr_t> (first));
+
+                               if (n == 1)
+                                 stride = d;
+
+                               if (d != static_cast<std::ptrdiff_t> (n) * stride)
+                               {
+                                 f (first, n, stride);
+                                 n = 0;
+                               }
+                             }
+
+                             if (n == 0)
+                             {
+                               first  = &e;
+                               stride = sizeof (local_reporter_type);
+                             }
+                             ++n;
+                           });
+
+        if (n != 0)
+          f (first, n, stride);
+      }
+
+      // safe to use, but may throw
+      rptrs_iter
+      track (rptrs_citer pos, remote_base_type& remote)
+      {
+        stats_hook::count (tracker_event::bind);
+        return rptrs_emplace (pos, tag::track, remote);
+      }
+
+      //! as above, at the sorted position of `remote`
+      rptrs_iter
+      track_sorted (remote_base_type& remote)
+      {
+        stats_hook::count (tracker_event::bind);
+        const guard_type guard (*this);
+        return emplace_reporter (find_sorted_pos (remote), tag::track, remote);
+      }
+
+      GCH_NODISCARD GCH_CPP17_CONSTEXPR
+      typename std::iterator_traits<rptrs_citer>::difference_type
+      get_reporter_offset (rptrs_citer pos) const noexcept
+      {
+        return get_reporter_offset (pos, typename Storage::is_indexed { });
+      }
+
+      GCH_NODISCARD static
+      rptrs_handle
+      rptrs_handle_of (rptrs_iter pos) noexcept
+      {
+        return rptrs_handle_of (pos, typename Storage::is_compact { });
+      }
+
+      GCH_NODISCARD
+      rptrs_iter
+      rptrs_at (rptrs_handle h) noexcept
+      {
+        return rptrs_at (h, typename Storage::is_compact { });
+      }
+
+      //! only available with compact storage
+      template <typename S = Storage,
+                typename std::enable_if<S::is_compact::value>::type * = nullptr>
+      GCH_NODISCARD
+      tracker_handle
+      rptrs_weak_handle_of (rptrs_citer pos) const noexcept
+      {
+        const reporters_shared_guard<tracker_base> guard (*this);
+        const std::uint32_t index = reporter_list::handle_of (pos);
+        return { index, m_rptrs.generation_of (index) };
+      }
+
+      //! the reporter of `h`, or the end if it has since been erased or moved
+      template <typename S = Storage,
+                typename std::enable_if<S::is_compact::value>::type * = nullptr>
+      GCH_NODISCARD
+      rptrs_iter
+      rptrs_find_weak (const tracker_handle h) noexcept
+      {
+        const reporters_shared_guard<tracker_base> guard (*this);
+        if (m_rptrs.is_current (h.index, h.generation))
+          return m_rptrs.at (h.index);
+        return m_rptrs.end ();
+      }
+
+      template <typename S = Storage,
+                typename std::enable_if<S::is_compact::value>::type * = nullptr>
+      GCH_NODISCARD
+      rptrs_citer
+      rptrs_find_weak (const tracker_handle h) const noexcept
+      {
+        return const_cast<tracker_base&> (*this).rptrs_find_weak (h);
+      }
+
+      //! points the remotes of [first, last) at *this
+      void
+      repoint_reporters (rptrs_iter first, rptrs_iter last) noexcept
+      {
+        repoint_reporters (first, last, *this);
+      }
+
+      //! as above, where the reporters of `src` have just been moved into *this
+      void
+      repoint_reporters (rptrs_iter first, rptrs_iter last, const tracker_base& src) noexcept
+      {
+        repoint_reporters (first, last, src, typename Storage::is_splice_stable { });
+      }
+
+      //! points the remotes of [first, last) at *this and at their current positions
+      void
+      reseat_reporters (rptrs_iter first, const rptrs_iter last) noexcept
+      {
+        reseat_reporters (first, last, *this);
+      }
+
+      //! as above, where the reporters of `src` have just been moved into *this
+      void
+      reseat_reporters (rptrs_iter first, const rptrs_iter last, const tracker_base& src) noexcept
+      {
+        for (; first != last; ++first)
+        {
+          stats_hook::count (tracker_event::repoint);
+          modify_remote_reporter (*first, src, [this, first](remote_reporter_type& r)
+                                               {
+                                                 r.set (*this, first);
+                                               });
+        }
+      }
+
+      //! with linked storage, points the neighbors of the node `n` back at it after it
+      //! was relocated along with its reporter, then changes its remote with `f`
+      template <typename Node, typename Function>
+      rptrs_iter
+      relink_reporter (Node& n, Function f) noexcept
+      {
+        const guard_type guard (*this);
+        const rptrs_iter it = m_rptrs.relink (n);
+        f (*it);
+        return it;
+      }
+
+      //! changes the remote of `r`, which must be held by `*this`, with `f`
+      template <typename Function>
+      void
+      modify_reporter (local_reporter_type& r, Function f) noexcept
+      {
+        const guard_type guard (*this);
+        modify_reporter (r, f, is_keyed { });
+      }
+
+      GCH_NODISCARD
+      rptrs_iter
+      find_reporter (const remote_base_type& r) noexcept
+      {
+        return find_reporter (r, is_keyed { });
+      }
+
+      GCH_NODISCARD
+      rptrs_citer
+      find_reporter (const remote_base_type& r) const noexcept
+      {
+        return const_cast<tracker_base&> (*this).find_reporter (r);
+      }
+
+      //! safe, symmetric
+      rptrs_iter
+      debind_remote (rptrs_citer pos) noexcept
+      {
+        return debind_remote (pos, ignore_debind { });
+      }
+
+      //! as above, then calls `notify` with the remote
+      template <typename Notify,
+                typename std::enable_if<
+                  ! std::is_convertible<Notify, rptrs_citer>::value>::type * = nullptr>
+      rptrs_iter
+      debind_remote (rptrs_citer pos, Notify notify) noexcept
+      {
+        stats_hook::count (tracker_event::debind);
+        stats_hook::count (tracker_event::remote_write);
+        remote_base_type& remote = pos->get_remote_base ();
+        pos->reset_remote_tracking ();
+        const rptrs_iter ret = rptrs_erase (pos);
+        notify (remote);
+        return ret;
+      }
+
+      //! safe
+      rptrs_iter
+      debind_remote (rptrs_citer first, const rptrs_citer last) noexcept
+      {
+        return debind_remote (first, last, ignore_debind { });
+      }
+
+      template <typename Notify>
+      rptrs_iter
+      debind_remote (rptrs_citer first, const rptrs_citer last, Notify notify) noexcept
+      {
+        while (first != last)
+          first = debind_remote (first, notify);
+        return rptrs_erase (last, last);
+      }
+
+      //! safe; debinds every reporter tracking `r`
+      void
+      debind_remote (const remote_base_type& r) noexcept
+      {
+        debind_remote (r, ignore_debind { });
+      }
+
+      template <typename Notify,
+                typename std::enable_if<
+                  ! std::is_convertible<Notify, rptrs_citer>::value>::type * = nullptr>
+      void
+      debind_remote (const remote_base_type& r, Notify notify) noexcept
+      {
+        debind_remote (r, notify, is_keyed { });
+      }
+
+      //! safe
+      template <typename Pred>
+      void
+      base_remove_if (Pred pred)
+      {
+        m_rptrs.remove_if ([&](const local_reporter_type& e)
+                           {
+                             if (pred (e))
+                             {
+                               stats_hook::count (tracker_event::debind);
+                               stats_hook::count (tracker_event::remote_write);
+                               e.reset_remote_tracking ();
+                               return true;
+                             }
+                             return false;
+                           });
+      }
+
+      rptrs_iter
+      rebind_remote (rptrs_citer pos, remote_base_type& r)
+      {
+        return rebind_remote (pos, r, tag::is_tracker_base<remote_base_tag> { });
+      }
+
+      rptrs_iter
+      rebind_remote (rptrs_citer pos, remote_base_type&& r)
+      {
+        return rebind_remote (pos, r);
+      }
+
+      rptrs_iter
+      rebind_remote (const rptrs_citer pos, const rptrs_citer first, const rptrs_citer last)
+      {
+        return rebind_remotes (pos, first, last,
+                               [](const local_reporter_type& e) -> remote_base_type&
+                               {
+                                 return e.get_remote_base ();
+                               },
+                               typename Storage::is_sorted { });
+      }
+
+      template <typename InterfaceRef, typename Iterator>
+      rptrs_iter
+      rebind_remote (const rptrs_citer pos, const Iterator first, const Iterator last)
+      {
+        return rebind_remotes (pos, first, last,
+                               [](decltype (*first) e) -> remote_base_type&
+                               {
+                                 InterfaceRef r = static_cast<InterfaceRef> (e);
+                                 return r;
+                               },
+                               typename Storage::is_sorted { });
+      }
+
+      //! binds each remote of [first, last) at its sorted position, in one pass over *this
+      template <typename InterfaceRef, typename Iterator>
+      void
+      bulk_rebind_remote (Iterator first, const Iterator last)
+      {
+        std::vector<remote_base_type *> remotes;
+        for (; first != last; ++first)
+        {
+          InterfaceRef      r = static_cast<InterfaceRef> (*first);
+          remote_base_type& b = r;
+          remotes.push_back (&b);
+        }
+        std::sort (remotes.begin (), remotes.end (), std::less<remote_base_type *> { });
+        bulk_rebind_remote (remotes, typename Storage::is_sorted { });
+      }
+
+      void
+      replace_remote (rptrs_iter pos, remote_base_type& r)
+      {
+        replace_remote (pos, r, tag::is_tracker_base<remote_base_tag> { });
+      }
+
+      void
+      merge_reporters (tracker_base& other)
+      {
+        // sorted storage restores its own order, so it need not be checked
+        assert ((Storage::is_sorted::value || has_sorted_reporters ())
+                && "`*this` must be sorted in order to merge");
+        assert ((Storage::is_sorted::value || other.has_sorted_reporters ())
+                && "`other` must be sorted in order to merge");
+        if (! rptrs_alloc_equal (other))
+        {
+          // copy over the elements of `other` one at a time, in a single pass over *this
+          rptrs_citer pos = rptrs_cbegin ();
+          while (! other.rptrs_empty ())
+          {
+            const rptrs_citer first = other.rptrs_cbegin ();
+            pos = std::find_if (pos, rptrs_cend (),
+                                [first](const local_reporter_type& e) { return *first < e; });
+            transfer_reporters (pos, other, first, std::next (first));
+          }
+          return;
+        }
+        m_rptrs.merge (other.m_rptrs);
+        repoint_reporters (rptrs_begin (), rptrs_end (), other);
+      }
+
+      //! O(1) with sorted storage
+      GCH_NODISCARD
+      bool
+      has_sorted_reporters (void) const
+      {
+        return has_sorted_reporters (typename Storage::is_sorted { });
+      }
+
+      void
+      sort_reporters (void)
+      {
+        m_rptrs.sort ();
+      }
+
+      //! O(log n) with sorted storage
+      rptrs_citer
+      find_sorted_pos (const remote_base_type& r) const
+      {
+        return find_sorted_pos (r, typename Storage::is_sorted { });
+      }
+
+    private:
+      rptrs_iter
+      splice_reporters (const rptrs_citer pos, tracker_base& src, std::false_type)
+      {
+        // the spliced elements may have been relocated, so find them from the element before
+        const bool at_front = (pos == rptrs_cbegin ());
+        const rptrs_citer prev = at_front ? pos : std::prev (pos);
+
+        // splice is unsafe
+        m_rptrs.splice (pos, src.m_rptrs);
+
+        // repoint_reporters is safe; only the spliced reporters need it
+        const rptrs_iter first = at_front ? rptrs_begin () : std::next (rptrs_erase (prev, prev));
+        repoint_reporters (first, rptrs_erase (pos, pos), src);
+        return first;
+      }
+
+      // The spliced reporters are merged in among the others, so every reporter
+      // is repointed (which is harmless for those which were already here).
+      template <typename Sorted = std::true_type>
+      rptrs_iter
+      splice_reporters (const rptrs_citer pos, tracker_base& src, Sorted)
+      {
+        m_rptrs.splice (pos, src.m_rptrs);
+        repoint_reporters (rptrs_begin (), rptrs_end (), src);
+        return rptrs_begin ();
+      }
+
+      rptrs_iter
+      transfer_reporters (const rptrs_citer pos, tracker_base& other,
+                          const rptrs_citer other_first, const rptrs_citer other_last,
+                          std::false_type)
+      {
+        return transfer_reporters (pos, other, other_first, other_last, std::false_type { },
+                                   relinks_nodes { });
+      }
+
+      rptrs_iter
+      transfer_reporters (const rptrs_citer pos, tracker_base& other,
+                          const rptrs_citer other_first, const rptrs_citer other_last,
+                          std::false_type, std::false_type)
+      {
+        const rptrs_iter ret = m_rptrs.insert (pos, other_first, other_last);
+        reseat_reporters (ret, rptrs_erase (pos, pos));
+        other.m_rptrs.erase (other_first, other_last);
+        return ret;
+      }
+
+      template <typename Relinks = std::true_type>
+      rptrs_iter
+      transfer_reporters (const rptrs_citer pos, tracker_base& other,
+                          const rptrs_citer other_first, const rptrs_citer other_last,
+                          std::false_type, Relinks) noexcept
+      {
+        const rptrs_iter ret = m_rptrs.splice (pos, other.m_rptrs, other_first, other_last);
+        repoint_reporters (ret, rptrs_erase (pos, pos), other);
+        return ret;
+      }
+
+      // The transferred reporters are not contiguous, so they are moved over one at
+      // a time. If copying one throws, those which were moved so far stay moved.
+      template <typename Sorted = std::true_type>
+      rptrs_iter
+      transfer_reporters (const rptrs_citer pos, tracker_base& other,
+                          rptrs_citer other_first, const rptrs_citer other_last, Sorted)
+      {
+        if (other_first == other_last)
+          return rptrs_erase (pos, pos);
+
+        const rptrs_iter ret = emplace_reporter (pos, *other_first);
+        reseat_reporters (ret, std::next (ret));
+        other_first = other.m_rptrs.erase (other_first);
+
+        while (other_first != other_last)
+        {
+          const rptrs_iter it = emplace_reporter (pos, *other_first);
+          reseat_reporters (it, std::next (it));
+          other_first = other.m_rptrs.erase (other_first);
+        }
+        return ret;
+      }
+
+      // with unsorted storage, the new reporters are contiguous and end at `pos`
+      template <typename Iterator, typename GetRemote>
+      rptrs_iter
+      rebind_remotes (const rptrs_citer pos, Iterator first, const Iterator last,
+                      GetRemote get_remote, std::false_type)
+      {
+        if (first == last)
+          return rptrs_erase (pos, pos);
+
+        const rptrs_iter pivot = rebind_remote (pos, get_remote (*first));
+        try
+        {
+          while (++first != last)
+            rebind_remote (pos, get_remote (*first));
+        }
+        catch (...)
+        {
+          debind_remote (pivot, pos);
+          throw;
+        }
+        return pivot;
+      }
+
+      // with sorted storage they are not, so they are kept in case they must be debound
+      template <typename Iterator, typename GetRemote, typename Sorted = std::true_type>
+      rptrs_iter
+      rebind_remotes (const rptrs_citer pos, Iterator first, const Iterator last,
+                      GetRemote get_remote, Sorted)
+      {
+        if (first == last)
+          return rptrs_erase (pos, pos);
+
+        std::vector<rptrs_iter> bound;
+        try
+        {
+          for (; first != last; ++first)
+          {
+            if (bound.size () == bound.capacity ())
+              bound.reserve (2 * bound.size () + 1);
+            bound.push_back (rebind_remote (pos, get_remote (*first)));
+          }
+        }
+        catch (...)
+        {
+          for (const rptrs_iter it : bound)
+            debind_remote (it);
+          throw;
+        }
+        return bound.front ();
+      }
+
+      void
+      bulk_rebind_remote (const std::vector<remote_base_type *>& remotes, std::false_type)
+      {
+        // each remote goes after the last, so the search picks up where it left off
+        rptrs_citer pos = rptrs_cbegin ();
+        for (remote_base_type *r : remotes)
+        {
+          pos = std::find_if (pos, rptrs_cend (),
+                              [r](const local_reporter_type& e) { return ! (e < r); });
+          pos = std::next (rebind_remote (pos, *r));
+        }
+      }
+
+      // sorted storage finds the positions itself
+      template <typename Sorted = std::true_type>
+      void
+      bulk_rebind_remote (const std::vector<remote_base_type *>& remotes, Sorted)
+      {
+        for (remote_base_type *r : remotes)
+          rebind_remote (rptrs_cend (), *r);
+      }
+
+      GCH_NODISCARD
+      bool
+      has_sorted_reporters (std::false_type) const
+      {
+        return std::is_sorted (rptrs_begin (), rptrs_end ());
+      }
+
+      template <typename Sorted = std::true_type>
+      GCH_NODISCARD
+      bool
+      has_sorted_reporters (Sorted) const noexcept
+      {
+        return m_rptrs.is_sorted ();
+      }
+
+      rptrs_citer
+      find_sorted_pos (const remote_base_type& r, std::false_type) const
+      {
+        return std::lower_bound (rptrs_begin (), rptrs_end (), &r);
+      }
+
+      template <typename Sorted = std::true_type>
+      rptrs_citer
+      find_sorted_pos (const remote_base_type& r, Sorted) const noexcept
+      {
+        return m_rptrs.lower_bound (&r);
+      }
+
+      void
+      detach_reporter (rptrs_citer pos, std::false_type) noexcept
+      {
+        rptrs_erase (pos);
+      }
+
+      template <typename Tombstoned = std::true_type>
+      void
+      detach_reporter (rptrs_citer pos, Tombstoned) noexcept
+      {
+        m_rptrs.kill (pos);
+        lock_base::synchronize_reporters ();
+      }
+
+      template <typename Function>
+      void
+      for_each_reporter (Function f, std::false_type) const
+      {
+        for (const local_reporter_type& e : m_rptrs)
+          f (e);
+      }
+
+      template <typename Function, typename Tombstoned = std::true_type>
+      void
+      for_each_reporter (Function f, Tombstoned) const
+      {
+        m_rptrs.for_each_live (f);
+      }
+
+      template <typename Function, typename Executor>
+      void
+      parallel_for_each_reporter (Function& f, Executor& executor, std::size_t num_tasks,
+                                  std::false_type) const
+      {
+        parallel_for_each_chunk (m_rptrs.cbegin (), m_rptrs.cend (), m_rptrs.size (), num_tasks,
+                                 executor, [&f](rptrs_citer first, const rptrs_citer last)
+                                           {
+                                             for (; first != last; ++first)
+                                               f (*first);
+                                           });
+      }
+
+      // the runs are taken from the uncompacted list, since readers may not compact it
+      template <typename Function, typename Executor, typename Tombstoned = std::true_type>
+      void
+      parallel_for_each_reporter (Function& f, Executor& executor, std::size_t num_tasks,
+                                  Tombstoned) const
+      {
+        parallel_for_each_chunk (m_rptrs.uncompacted_cbegin (), m_rptrs.uncompacted_cend (),
+                                 m_rptrs.size (), num_tasks, executor,
+                                 [this, &f](const rptrs_citer first, const rptrs_citer last)
+                                 {
+                                   m_rptrs.for_each_live (first, last, f);
+                                 });
+      }
+
+      static
+      void
+      compact_reporters (std::false_type) noexcept
+      { }
+
+      template <typename Tombstoned = std::true_type>
+      void
+      compact_reporters (Tombstoned) noexcept
+      {
+        const guard_type guard (*this);
+        m_rptrs.compact ();
+      }
+
+      GCH_CPP17_CONSTEXPR
+      typename std::iterator_traits<rptrs_citer>::difference_type
+      get_reporter_offset (rptrs_citer pos, std::false_type) const noexcept
+      {
+        return std::distance (rptrs_cbegin (), pos);
+      }
+
+      template <typename Compact = std::true_type>
+      static
+      rptrs_handle
+      rptrs_handle_of (rptrs_iter pos, Compact) noexcept
+      {
+        return reporter_list::handle_of (pos);
+      }
+
+      static
+      rptrs_handle
+      rptrs_handle_of (rptrs_iter pos, std::false_type) noexcept
+      {
+        return pos;
+      }
+
+      template <typename Compact = std::true_type>
+      rptrs_iter
+      rptrs_at (rptrs_handle h, Compact) noexcept
+      {
+        return m_rptrs.at (h);
+      }
+
+      static
+      rptrs_iter
+      rptrs_at (rptrs_handle h, std::false_type) noexcept
+      {
+        return h;
+      }
+
+      template <typename Indexed = std::true_type>
+      typename std::iterator_traits<rptrs_citer>::difference_type
+      get_reporter_offset (rptrs_citer pos, Indexed) const noexcept
+      {
+        using diff_type = typename std::iterator_traits<rptrs_citer>::difference_type;
+        return static_cast<diff_type> (m_rptrs.index_of (pos));
+      }
+
+      template <typename Propagate = std::true_type>
+      void
+      move_reporters (tracker_base& other, Propagate) noexcept
+      {
+        m_rptrs = std::move (other.m_rptrs);
+        repoint_reporters (rptrs_begin (), rptrs_end (), other);
+      }
+
+      // The allocator stays with *this. If it differs from that of `other`, the
+      // reporters are copied over, which may throw (and so terminate).
+      void
+      move_reporters (tracker_base& other, std::false_type) noexcept
+      {
+        splice_reporters (rptrs_cend (), other);
+      }
+
+      void
+      repoint_reporters (rptrs_iter first, rptrs_iter last, const tracker_base& src,
+                         std::true_type) noexcept
+      {
+        std::for_each (first, last,
+                       [this, &src](local_reporter_type& rptr)
+                       {
+                         stats_hook::count (tracker_event::repoint);
+                         modify_remote_reporter (rptr, src, [this](remote_reporter_type& r)
+                                                            {
+                                                              r.track (*this);
+                                                            });
+                       });
+      }
+
+      void
+      repoint_reporters (rptrs_iter first, rptrs_iter last, const tracker_base& src,
+                         std::false_type) noexcept
+      {
+        reseat_reporters (first, last, src);
+      }
+
+      // The remote reporters are held by whichever tracker the reporters point
+      // to, except for those which were held by `src`, which are now in *this.
+      template <typename Function>
+      void
+      modify_remote_reporter (local_reporter_type& rptr, const tracker_base& src,
+                              Function f) noexcept
+      {
+        stats_hook::count (tracker_event::remote_write);
+        modify_remote_reporter (rptr, src, f, std::is_same<remote_base_type, tracker_base> { });
+      }
+
+      template <typename Function>
+      static
+      void
+      modify_remote_reporter (local_reporter_type& rptr, const tracker_base&, Function f,
+                              std::false_type) noexcept
+      {
+        modify_remote_reporter (rptr, f);
+      }
+
+      template <typename Function>
+      void
+      modify_remote_reporter (local_reporter_type& rptr, const tracker_base& src, Function f,
+                              std::true_type) noexcept
+      {
+        if (rptr.get_remote_base_ptr () == &src)
+          modify_reporter (rptr.get_remote_reporter (), f);
+        else
+          modify_remote_reporter (rptr, f);
+      }
+
+      template <typename Function>
+      static
+      void
+      modify_remote_reporter (local_reporter_type& rptr, Function f) noexcept
       {
-        return m_rptrs.empty ();
+        modify_remote_reporter (rptr, f, tag::is_tracker_base<remote_base_tag> { });
       }
 
-      GCH_NODISCARD
-      rptrs_size_ty
-      rptrs_size (void) const noexcept
+      // with remote reporter
+      template <typename Function>
+      static
+      void
+      modify_remote_reporter (local_reporter_type& rptr, Function f, std::false_type) noexcept
       {
-        return m_rptrs.size ();
+        f (rptr.get_remote_reporter ());
       }
 
-      GCH_NODISCARD
-      rptrs_size_ty
-      rptrs_max_size (void) const noexcept
+      // with remote tracker (the remote may keep an index)
+      template <typename Function>
+      static
+      void
+      modify_remote_reporter (local_reporter_type& rptr, Function f, std::true_type) noexcept
       {
-        return m_rptrs.max_size ();
+        rptr.get_remote_base ().modify_reporter (rptr.get_remote_reporter (), f);
       }
 
-      template <typename ...Args>
-      rptrs_iter
-      rptrs_emplace (rptrs_citer pos, Args&&... args)
+      template <typename Function>
+      static
+      void
+      modify_reporter (local_reporter_type& r, Function f, std::false_type) noexcept
       {
-        return m_rptrs.emplace (pos, std::forward<Args> (args)...);
+        f (r);
       }
 
-      template <typename ...Args>
-      rptrs_iter
-      rptrs_erase (Args&&... args) noexcept
+      template <typename Function>
+      void
+      modify_reporter (local_reporter_type& r, Function f, std::true_type) noexcept
       {
-        return m_rptrs.erase (std::forward<Args> (args)...);
+        m_rptrs.modify (r, f);
       }
 
-      // safe to use, but may throw
       rptrs_iter
-      track (rptrs_citer pos, remote_base_type& remote)
+      find_reporter (const remote_base_type& r, std::false_type) noexcept
       {
-        return m_rptrs.emplace (pos, tag::track, remote);
+        return std::find_if (rptrs_begin (), rptrs_end (),
+                             [&r](const local_reporter_type& e)
+                             {
+                               return e.get_remote_base_ptr () == &r;
+                             });
       }
 
-      GCH_NODISCARD GCH_CPP17_CONSTEXPR
-      typename std::iterator_traits<rptrs_citer>::difference_type
-      get_reporter_offset (rptrs_citer pos) const noexcept
+      template <typename Keyed = std::true_type>
+      rptrs_iter
+      find_reporter (const remote_base_type& r, Keyed) noexcept
       {
-        return std::distance (rptrs_cbegin (), pos);
+        return m_rptrs.find (&r);
       }
 
+      template <typename Notify>
       void
-      repoint_reporters (rptrs_iter first, rptrs_iter last) noexcept
+      debind_remote (const remote_base_type& r, Notify notify, std::false_type) noexcept
       {
-        std::for_each (first, last,
-                       [this](local_reporter_type& rptr)
-                       {
-                         rptr.get_remote_reporter ().track (*this);
-                       });
+        auto pred = [&r](const local_reporter_type& e) { return e.get_remote_base_ptr () == &r; };
+        rptrs_citer pos = std::find_if (rptrs_cbegin (), rptrs_cend (), pred);
+        while (pos != rptrs_cend ())
+          pos = std::find_if (rptrs_citer (debind_remote (pos, notify)), rptrs_cend (), pred);
       }
 
-      //! safe, symmetric
-      rptrs_iter
-      debind_remote (rptrs_citer pos) noexcept
+      template <typename Notify, typename Keyed = std::true_type>
+      void
+      debind_remote (const remote_base_type& r, Notify notify, Keyed) noexcept
       {
-        pos->reset_remote_tracking ();
-        return rptrs_erase (pos);
+        for (rptrs_citer pos = m_rptrs.find (&r); pos != rptrs_cend (); pos = m_rptrs.find (&r))
+          debind_remote (pos, notify);
       }
 
-      //! safe
+      // with remote reporter
+      template <typename RemoteBase>
       rptrs_iter
-      debind_remote (rptrs_citer first, const rptrs_citer last) noexcept
+      rebind_remote (const rptrs_citer pos, RemoteBase& r, std::false_type)
       {
-        while (first != last)
-          first = debind_remote (first);
-        return rptrs_erase (last, last);
+        stats_hook::count (tracker_event::bind);
+        stats_hook::count (tracker_event::remote_write);
+        return track_remote (pos, r, typename Storage::is_linked { });
       }
 
-      //! safe
-      template <typename Pred>
-      void
-      base_remove_if (Pred pred)
+      template <typename RemoteBase>
+      rptrs_iter
+      track_remote (const rptrs_citer pos, RemoteBase& r, std::false_type)
       {
-        m_rptrs.remove_if ([&](const local_reporter_type& e)
-                           {
-                             if (pred (e))
-                             {
-                               e.reset_remote_tracking ();
-                               return true;
-                             }
-                             return false;
-                           });
+        const rptrs_iter local_it = rptrs_emplace (pos, tag::track, r);
+        r.reset (*this, local_it);
+        return local_it;
       }
 
+      // The node is kept by `r`, so it has to leave the old remote of `r` first. If
+      // that was `pos` itself, the new element goes where `pos` was.
+      template <typename RemoteBase, typename Linked = std::true_type>
       rptrs_iter
-      rebind_remote (rptrs_citer pos, remote_base_type& r);
+      track_remote (rptrs_citer pos, RemoteBase& r, Linked) noexcept
+      {
+        if (pos != rptrs_cend () && pos->get_remote_base_ptr () == &r)
+          ++pos;
+        r.reset_remote_tracking ();
+        const rptrs_iter local_it = rptrs_emplace (pos, tag::track, r);
+        r.set (*this, local_it);
+        return local_it;
+      }
 
+      // with remote tracker
+      template <typename RemoteBase>
       rptrs_iter
-      rebind_remote (rptrs_citer pos, remote_base_type&& r)
+      rebind_remote (const rptrs_citer pos, RemoteBase& r, std::true_type)
       {
-        return rebind_remote (pos, r);
+        stats_hook::count (tracker_event::bind);
+        RemoteBase::stats_hook::count (tracker_event::bind);
+
+        // both ends have to appear at once so that neither can be debound half-made
+        const reporters_pair_guard<tracker_base, RemoteBase> guard (*this, r);
+        return link_remote (pos, r, typename Storage::is_paired { });
       }
 
+      template <typename RemoteBase>
       rptrs_iter
-      rebind_remote (const rptrs_citer pos, rptrs_citer first, const rptrs_citer last)
+      link_remote (const rptrs_citer pos, RemoteBase& r, std::false_type)
       {
-        if (first == last)
-          return rptrs_erase (pos, pos);
-
-        const rptrs_iter pivot = rebind_remote (pos, first->get_remote_base ());
+        const rptrs_iter local_it = emplace_reporter (pos, tag::track, r);
         try
         {
-          while (++first != last)
-            rebind_remote (pos, first->get_remote_base ());
+          const auto remote_it = r.emplace_reporter (r.m_rptrs.end (), tag::track, *this);
+          local_it ->set_access (remote_it);
+          remote_it->set_access (local_it);
         }
         catch (...)
         {
-          debind_remote (pivot, pos);
+          m_rptrs.erase (local_it);
           throw;
         }
-        return pivot;
+        return local_it;
       }
 
-      template <typename InterfaceRef, typename Iterator>
+      // both ends come from a single allocation, which is counted once by *this
+      template <typename RemoteBase, typename Paired = std::true_type>
       rptrs_iter
-      rebind_remote (const rptrs_citer pos, Iterator first, const Iterator last)
+      link_remote (const rptrs_citer pos, RemoteBase& r, Paired)
       {
-        if (first == last)
-          return rptrs_erase (pos, pos);
+        static_assert (std::is_same<RemoteBase, tracker_base>::value,
+                       "both trackers must have the same paired storage");
 
-        const rptrs_iter pivot = rebind_remote (pos, static_cast<InterfaceRef> (*first));
-        try
-        {
-          while (++first != last)
-            rebind_remote (pos, static_cast<InterfaceRef> (*first));
-        }
-        catch (...)
-        {
-          debind_remote (pivot, pos);
-          throw;
-        }
-        return pivot;
+        const std::size_t prev_capacity = stats_hook::capacity_of (m_rptrs);
+        const auto its = m_rptrs.emplace_pair (pos, local_reporter_type (tag::track, r),
+                                               r.m_rptrs, r.m_rptrs.end (),
+                                               local_reporter_type (tag::track, *this));
+        stats_hook::count_growth (m_rptrs, prev_capacity);
+        its.first ->set_access (its.second);
+        its.second->set_access (its.first);
+        return its.first;
       }
 
+      // with remote reporter
+      template <typename RemoteBase>
       void
-      replace_remote (rptrs_iter pos, remote_base_type& r);
-
-      void
-      merge_reporters (tracker_base& other)
+      replace_remote (const rptrs_iter pos, RemoteBase& r, std::false_type)
       {
-        assert (has_sorted_reporters () && "`*this` must be sorted in order to merge");
-        assert (other.has_sorted_reporters () && "`other` must be sorted in order to merge");
-        m_rptrs.merge (other.m_rptrs);
+        stats_hook::count (tracker_event::bind);
+        stats_hook::count (tracker_event::remote_write);
+        replace_remote (pos, r, std::false_type { }, typename Storage::is_linked { });
       }
 
-      GCH_NODISCARD
-      bool
-      has_sorted_reporters (void) const
+      template <typename RemoteBase>
+      void
+      replace_remote (const rptrs_iter pos, RemoteBase& r, std::false_type, std::false_type)
       {
-        return std::is_sorted (rptrs_begin (), rptrs_end ());
+        r.reset (*this, pos);
+        modify_reporter (*pos, [&r](local_reporter_type& e) { e.reset (r); });
       }
 
+      // the node at `pos` belongs to the old remote, so `r` brings its own in its place
+      template <typename RemoteBase, typename Linked = std::true_type>
       void
-      sort_reporters (void)
+      replace_remote (const rptrs_iter pos, RemoteBase& r, std::false_type, Linked) noexcept
       {
-        m_rptrs.sort ();
+        if (pos->get_remote_base_ptr () == &r)
+          return;
+        pos->reset_remote_tracking ();
+        track_remote (rptrs_erase (pos), r, Linked { });
       }
 
-      rptrs_citer
-      find_sorted_pos (const remote_base_type& r) const
+      // with remote tracker
+      template <typename RemoteBase>
+      void
+      replace_remote (const rptrs_iter pos, RemoteBase& r, std::true_type)
       {
-        return std::lower_bound (rptrs_begin (), rptrs_end (), &r);
+        replace_remote (pos, r, std::true_type { }, typename Storage::is_paired { });
       }
 
-    private:
-      reporter_list m_rptrs;
-    };
+      template <typename RemoteBase>
+      void
+      replace_remote (const rptrs_iter pos, RemoteBase& r, std::true_type, std::false_type)
+      {
+        stats_hook::count (tracker_event::bind);
+        RemoteBase::stats_hook::count (tracker_event::bind);
+        const auto remote_it = r.rptrs_emplace (r.rptrs_end (), tag::track, *this);
+        pos->reset_remote_tracking ();
 
-    template <>
-    inline
-    auto
-    tracker_base<tag::reporter_base>::
-    rebind_remote (const rptrs_citer pos, reporter_base<tag::reporter_base, tag::tracker_base>& r)
-      -> rptrs_iter
-    {
-      const rptrs_iter local_it = rptrs_emplace (pos, tag::track, r);
-      r.reset (*this, local_it);
-      return local_it;
-    }
+        const reporters_pair_guard<tracker_base, RemoteBase> guard (*this, r);
+        modify_reporter (*pos, [&r, remote_it](local_reporter_type& e) { e.set (r, remote_it); },
+                         is_keyed { });
+        remote_it->set_access (pos);
+      }
 
-    template <>
-    inline
-    auto
-    tracker_base<tag::tracker_base>::
-    rebind_remote (const rptrs_citer pos, tracker_base<tag::tracker_base>& r)
-      -> rptrs_iter
-    {
-      const rptrs_iter local_it = rptrs_emplace (pos);
-      try
+      // The old binding shares its allocation with the old remote, so it is freed
+      // and a new one is made in front of it.
+      template <typename RemoteBase, typename Paired = std::true_type>
+      void
+      replace_remote (const rptrs_iter pos, RemoteBase& r, std::true_type, Paired)
       {
-        const rptrs_iter remote_it = r.rptrs_emplace (r.rptrs_end ());
-        local_it ->set (r, remote_it);
-        remote_it->set (*this,  local_it );
+        rebind_remote (pos, r, std::true_type { });
+        debind_remote (pos);
       }
-      catch (...)
+
+      // emplaces without locking, and counts whether the storage had to grow
+      template <typename ...Args>
+      rptrs_iter
+      emplace_reporter (rptrs_citer pos, Args&&... args)
       {
-        rptrs_erase (local_it);
-        throw;
+        const std::size_t prev_capacity = stats_hook::capacity_of (m_rptrs);
+        const rptrs_iter ret = m_rptrs.emplace (pos, std::forward<Args> (args)...);
+        stats_hook::count_growth (m_rptrs, prev_capacity);
+        return ret;
       }
-      return local_it;
-    }
-
-    template <>
-    inline
-    void
-    tracker_base<tag::reporter_base>::
-    replace_remote (const rptrs_iter pos, reporter_base<tag::reporter_base, tag::tracker_base>& r)
-    {
-      r.reset (*this, pos);
-      pos->reset (r);
-    }
 
-    template <>
-    inline
-    void
-    tracker_base<tag::tracker_base>::
-    replace_remote (const rptrs_iter pos, tracker_base<tag::tracker_base>& r)
-    {
-      const rptrs_iter remote_it = r.rptrs_emplace (r.rptrs_end ());
-      pos->reset (r, remote_it);
-      remote_it->set (*this, pos);
-    }
+      reporter_list m_rptrs;
+    };
 
     template class tracker_base<tag::reporter_base>;
     template class tracker_base<tag::tracker_base>;
@@ -446,13 +1383,13 @@ namespace gch
     // tracker_common //
     ////////////////////
 
-    template <typename Parent, typename RemoteTag, typename IntrusiveTag>
-    class tracker_common<tracker<Parent, RemoteTag, IntrusiveTag>>
-      : private tracker_base<typename RemoteTag::base_tag>,
-        public tracker_traits<tracker<Parent, RemoteTag, IntrusiveTag>>
+    template <typename Parent, typename RemoteTag, typename IntrusiveTag, typename Storage>
+    class tracker_common<tracker<Parent, RemoteTag, IntrusiveTag, Storage>>
+      : private tracker_base<typename RemoteTag::base_tag, Storage>,
+        public tracker_traits<tracker<Parent, RemoteTag, IntrusiveTag, Storage>>
     {
-      using base = tracker_base<typename RemoteTag::base_tag>;
-      using traits = tracker_traits<tracker<Parent, RemoteTag, IntrusiveTag>>;
+      using base = tracker_base<typename RemoteTag::base_tag, Storage>;
+      using traits = tracker_traits<tracker<Parent, RemoteTag, IntrusiveTag, Storage>>;
 
     public:
       using local_tag  = typename traits::local_tag;
@@ -505,6 +1442,8 @@ namespace gch
       using iterator       = tracker_iterator<rptrs_iter, value_type, remote_interface_type>;
       using const_iterator = tracker_iterator<rptrs_citer, value_type, remote_interface_type>;
 
+      using segment_type = tracker_segment<local_reporter_type, value_type, remote_interface_type>;
+
       using reverse_iterator       = std::reverse_iterator<iterator>;
       using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
@@ -527,9 +1466,18 @@ namespace gch
       tracker_common            (const tracker_common&)     = delete;
       tracker_common            (tracker_common&&) noexcept = default;
       tracker_common& operator= (const tracker_common&)     = delete;
-      tracker_common& operator= (tracker_common&&) noexcept = default;
+//    tracker_common& operator= (tracker_common&&) noexcept = impl;
 //    ~tracker_common           (void)                      = impl;
 
+      tracker_common&
+      operator= (tracker_common&& other) noexcept
+      {
+        // clear first so that the remotes which are dropped are told of it
+        clear ();
+        base::operator= (std::move (other));
+        return *this;
+      }
+
       //! safe by default
       ~tracker_common (void)
       {
@@ -604,6 +1552,11 @@ namespace gch
         : tracker_common (gch::tag::bind, init.begin (), init.end ())
       { }
 
+      explicit
+      tracker_common (const allocator_type& alloc)
+        : base (alloc)
+      { }
+
       void
       swap (tracker_common& other) noexcept
       {
@@ -679,11 +1632,10 @@ namespace gch
                 const_iterator        other_first,
                 const_iterator        other_last)
       {
-        return base::transfer_reporters (
-          pos.base (),
-          other,
-          other_first.base (),
-          other_last.base ());
+        return iterator { base::transfer_reporters (pos.base (),
+                                                    other,
+                                                    other_first.base (),
+                                                    other_last.base ()) };
       }
 
       GCH_CPP14_CONSTEXPR
@@ -918,12 +1870,49 @@ namespace gch
       }
 
       GCH_NODISCARD
-      bool
+      size_type
       size (void) const noexcept
       {
         return base::rptrs_size ();
       }
 
+      GCH_NODISCARD
+      allocator_type
+      get_allocator (void) const noexcept
+      {
+        return base::rptrs_get_allocator ();
+      }
+
+      GCH_NODISCARD
+      size_type
+      capacity (void) const noexcept
+      {
+        return base::rptrs_capacity ();
+      }
+
+      //! Makes room for `n` bindings in total, so that binding up to that many
+      //! remotes doesn't allocate on this end. A bound tracker may still allocate.
+      void
+      reserve (const size_type n)
+      {
+        base::rptrs_reserve (n);
+      }
+
+      //! Gives back as much unused memory as possible. The bindings may be
+      //! relocated (and their remotes repointed), so iterators are invalidated.
+      void
+      shrink_to_fit (void)
+      {
+        base::rptrs_shrink_to_fit ();
+      }
+
+      //! gives back the memory which holds no bindings, without moving any bindings
+      void
+      trim (void) noexcept
+      {
+        base::rptrs_trim ();
+      }
+
       GCH_NODISCARD
       bool
       has_remotes (void) const noexcept
@@ -941,7 +1930,21 @@ namespace gch
       void
       clear (void) noexcept
       {
-        base::reset ();
+        base::reset (debind_notifier { });
+      }
+
+      //! As `clear`, but the remotes for which `is_dying` is true are left pointing at
+      //! *this, and are not told. Unsafe unless each of those is then cleared in the same
+      //! way, or wiped (see `destroy_all`).
+      template <typename Pred>
+      void
+      clear_except (Pred is_dying) noexcept
+      {
+        base::reset_external ([&is_dying](remote_base_type& r)
+                              {
+                                return is_dying (static_cast<remote_interface_type&> (r));
+                              },
+                              debind_notifier { });
       }
 
       void
@@ -950,6 +1953,59 @@ namespace gch
         base::wipe_reporters ();
       }
 
+      //! reclaims detached reporters now; only does anything with a tombstoned storage
+      void
+      compact (void) noexcept
+      {
+        base::compact_reporters ();
+      }
+
+      //! Calls `f` on each remote. With a concurrent storage, this may run alongside
+      //! other readers and detaching reporters; `f` may not bind or detach from *this.
+      template <typename Function>
+      void
+      for_each_remote (Function f) const
+      {
+        base::for_each_reporter ([&f](const typename base::local_reporter_type& e)
+                                 {
+                                   f (static_cast<remote_interface_type&> (
+                                        e.get_remote_base ()).get_parent ());
+                                 });
+      }
+
+      //! As above, with the remotes split into runs which are visited from the calling
+      //! thread and from up to `num_tasks - 1` tasks handed to `executor`, which may be
+      //! any callable which runs a `void ()` task (a thread pool, for example). `f` is
+      //! called from several threads at once. Returns once every remote has been
+      //! visited, and rethrows the first exception thrown by `f`.
+      template <typename Function, typename Executor>
+      void
+      parallel_for_each_remote (Function f, Executor&& executor,
+                                std::size_t num_tasks = std::thread::hardware_concurrency ()) const
+      {
+        base::parallel_for_each_reporter (
+          [&f](const typename base::local_reporter_type& e)
+          {
+            f (static_cast<remote_interface_type&> (e.get_remote_base ()).get_parent ());
+          }, executor, num_tasks);
+      }
+
+      //! Calls `f` on each run of bindings whose nodes lie evenly spaced in memory, in
+      //! order, as a tracker_segment. Nodes which were allocated one after another (as
+      //! with the blocks of plf::list, or the slots of compact storage) form long runs
+      //! which may be looped over without following links. Otherwise as above.
+      template <typename Function>
+      void
+      for_each_segment (Function f) const
+      {
+        base::for_each_reporter_run (
+          [&f](const local_reporter_type *first, std::size_t n, std::ptrdiff_t stride)
+          {
+            f (segment_type (first, n, stride));
+          });
+      }
+
+      //! O(1) with sorted storage, where it is only false after a remote has moved out of order
       GCH_NODISCARD
       bool
       is_sorted (void) const
@@ -961,7 +2017,7 @@ namespace gch
       size_type
       get_offset (const const_iterator pos) const noexcept
       {
-        return base::get_reporter_offset (pos.base ());
+        return static_cast<size_type> (base::get_reporter_offset (pos.base ()));
       }
 
       void
@@ -973,25 +2029,86 @@ namespace gch
           pos = std::find_if (erase (pos), end (), find_pred);
       }
 
+      //! constant time with a hashed storage, linear otherwise
       void
       debind (const remote_interface_type& r)
       {
-        auto find_pred = [&](const local_reporter_type& e) { return &e.get_remote_base () == &r; };
-        citer pos { std::find_if (begin ().base (), end ().base (), find_pred) };
-        while (pos != end ())
-          pos = std::find_if (erase (pos).base (), end ().base (), find_pred);
+        base::debind_remote (r, debind_notifier { });
+      }
+
+      //! returns a binding with `r`, or `end ()`; constant time with a hashed storage
+      GCH_NODISCARD
+      iterator
+      find (const remote_interface_type& r) noexcept
+      {
+        return iterator { base::find_reporter (r) };
+      }
+
+      GCH_NODISCARD
+      const_iterator
+      find (const remote_interface_type& r) const noexcept
+      {
+        return const_iterator { base::find_reporter (r) };
+      }
+
+      GCH_NODISCARD
+      bool
+      contains (const remote_interface_type& r) const noexcept
+      {
+        return find (r) != end ();
+      }
+
+      //! A weak reference to the binding at `pos`, which may be found again with
+      //! `find` in O(1). It goes stale once the binding is erased or moved to
+      //! another tracker, and when *this is assigned to or swapped. Only
+      //! available with compact storage.
+      template <typename S = Storage,
+                typename std::enable_if<S::is_compact::value>::type * = nullptr>
+      GCH_NODISCARD
+      tracker_handle
+      get_handle (const const_iterator pos) const noexcept
+      {
+        return base::rptrs_weak_handle_of (pos.base ());
+      }
+
+      //! returns the binding of `h`, or `end ()` if `h` is stale
+      template <typename S = Storage,
+                typename std::enable_if<S::is_compact::value>::type * = nullptr>
+      GCH_NODISCARD
+      iterator
+      find (const tracker_handle h) noexcept
+      {
+        return iterator { base::rptrs_find_weak (h) };
+      }
+
+      template <typename S = Storage,
+                typename std::enable_if<S::is_compact::value>::type * = nullptr>
+      GCH_NODISCARD
+      const_iterator
+      find (const tracker_handle h) const noexcept
+      {
+        return const_iterator { base::rptrs_find_weak (h) };
+      }
+
+      template <typename S = Storage,
+                typename std::enable_if<S::is_compact::value>::type * = nullptr>
+      GCH_NODISCARD
+      bool
+      is_valid (const tracker_handle h) const noexcept
+      {
+        return find (h) != end ();
       }
 
       iterator
       erase (const_iterator pos)
       {
-        return iterator { base::debind_remote (pos.base ()) };
+        return iterator { base::debind_remote (pos.base (), debind_notifier { }) };
       }
 
       iterator
       erase (const const_iterator first, const const_iterator last)
       {
-        return iterator { base::debind_remote (first.base (), last.base ()) };
+        return iterator { base::debind_remote (first.base (), last.base (), debind_notifier { }) };
       }
 
       template <typename Tag = remote_tag, tag::enable_if_tracker_t<Tag> * = nullptr>
@@ -1190,10 +2307,40 @@ namespace gch
         return ret;
       }
 
+      //! Binds each remote of [first, last) at its sorted position. Unlike `bind`, this
+      //! sorts the remotes and then makes a single pass over *this, which must be sorted.
+      //! If a binding throws, the remotes bound so far stay bound.
+      template <typename Iterator>
+      auto
+      bulk_bind (const Iterator first, const Iterator last)
+        -> typename std::enable_if<
+             std::is_constructible<remote_interface_type&&, decltype (*first)>::value>::type
+      {
+        base::template bulk_rebind_remote<remote_interface_type&&> (first, last);
+      }
+
+      template <typename Iterator>
+      auto
+      bulk_bind (const Iterator first, const Iterator last)
+        -> typename std::enable_if<
+                 tag::is_tracker<remote_tag>::value
+             &&! std::is_constructible<remote_interface_type&&, decltype (*first)>::value
+             &&  std::is_constructible<remote_interface_type&, decltype (*first)>::value>::type
+      {
+        base::template bulk_rebind_remote<remote_interface_type&> (first, last);
+      }
+
+      template <typename Tag = remote_tag, tag::enable_if_tracker_t<Tag> * = nullptr>
+      void
+      bulk_bind (std::initializer_list<std::reference_wrapper<remote_interface_type>> ilist)
+      {
+        bulk_bind (ilist.begin (), ilist.end ());
+      }
+
       void
       merge (local_interface_type& other)
       {
-        merge_reporters (other);
+        base::merge_reporters (other);
       }
 
       void
@@ -1219,6 +2366,17 @@ namespace gch
       {
         return citer { base::find_sorted_pos (cit.get_remote_interface ()) };
       }
+
+    private:
+      // tells the parent of each remote which *this drops (see has_debind_hook)
+      struct debind_notifier
+      {
+        void
+        operator() (remote_base_type& r) const noexcept
+        {
+          notify_debind (static_cast<remote_interface_type&> (r));
+        }
+      };
     }; // tracker_common
 
   } // gch::detail
@@ -1227,16 +2385,17 @@ namespace gch
   // tracker (intrusive) //
   /////////////////////////
 
-  template <typename Derived, typename RemoteTag>
-  class tracker<Derived, RemoteTag, tag::intrusive>
-    : public detail::tracker_common<tracker<Derived, RemoteTag, tag::intrusive>>
+  template <typename Derived, typename RemoteTag, typename Storage>
+  class tracker<Derived, RemoteTag, tag::intrusive, Storage>
+    : public detail::tracker_common<tracker<Derived, RemoteTag, tag::intrusive, Storage>>
   {
-    using base = detail::tracker_common<tracker<Derived, RemoteTag, tag::intrusive>>;
+    using base = detail::tracker_common<tracker<Derived, RemoteTag, tag::intrusive, Storage>>;
 
   public:
     using derived_type  = Derived;
     using remote_tag    = RemoteTag;
     using intrusive_tag = tag::intrusive;
+    using storage_type  = Storage;
 
     using base::base;
     tracker            (void)               = default;
@@ -1270,18 +2429,19 @@ namespace gch
   // tracker (nonintrusive) //
   ////////////////////////////
 
-  template <typename Parent, typename RemoteTag>
-  class tracker<Parent, RemoteTag, tag::nonintrusive>
-    : public detail::tracker_common<tracker<Parent, RemoteTag, tag::nonintrusive>>,
+  template <typename Parent, typename RemoteTag, typename Storage>
+  class tracker<Parent, RemoteTag, tag::nonintrusive, Storage>
+    : public detail::tracker_common<tracker<Parent, RemoteTag, tag::nonintrusive, Storage>>,
       public detail::nonintrusive_common<Parent>
   {
-    using base = detail::tracker_common<tracker<Parent, RemoteTag, tag::nonintrusive>>;
+    using base = detail::tracker_common<tracker<Parent, RemoteTag, tag::nonintrusive, Storage>>;
     using access_base = detail::nonintrusive_common<Parent>;
 
   public:
     using parent_type   = Parent;
     using remote_tag    = RemoteTag;
     using intrusive_tag = tag::nonintrusive;
+    using storage_type  = Storage;
 
     using base::base;
     tracker            (void)               = default;
@@ -1313,6 +2473,11 @@ namespace gch
       : access_base (parent)
     { }
 
+    tracker (parent_type& parent, const typename base::allocator_type& alloc)
+      : base        (alloc),
+        access_base (parent)
+    { }
+
     template <typename Tag = remote_tag,
               detail::tag::enable_if_reporter_t<Tag> * = nullptr>
     tracker (parent_type& parent,
@@ -1338,17 +2503,23 @@ namespace gch
     using base::base;
   };
 
-  template <typename Parent, typename Remote = Parent>
-  using multireporter = tracker<Parent, remote::tracker<Remote>>;
+  template <typename Parent, typename Remote = Parent, typename Storage = storage::list>
+  using multireporter = tracker<Parent, remote::tracker<Remote, Storage>, tag::nonintrusive,
+                                Storage>;
+
+  template <typename Derived, typename RemoteTag, typename Storage = storage::list>
+  using intrusive_tracker = tracker<Derived, RemoteTag, tag::intrusive, Storage>;
 
-  template <typename Derived, typename RemoteTag>
-  using intrusive_tracker = tracker<Derived, RemoteTag, tag::intrusive>;
+  // keeps up to N remotes inside the tracker before allocating
+  template <typename Parent, typename RemoteTag, std::size_t N,
+            typename IntrusiveTag = tag::nonintrusive>
+  using small_tracker = tracker<Parent, RemoteTag, IntrusiveTag, storage::small<N>>;
 
   namespace intrusive
   {
 
-    template <typename Derived, typename RemoteTag>
-    using tracker = gch::tracker<Derived, RemoteTag, tag::intrusive>;
+    template <typename Derived, typename RemoteTag, typename Storage = storage::list>
+    using tracker = gch::tracker<Derived, RemoteTag, tag::intrusive, Storage>;
 
   } // namespace gch::intrusive
 
@@ -1359,6 +2530,48 @@ namespace gch
     l.bind (remotes...);
   }
 
+  namespace detail
+  {
+
+    struct identity_projection
+    {
+      template <typename T>
+      constexpr
+      T&&
+      operator() (T&& t) const noexcept
+      {
+        return std::forward<T> (t);
+      }
+    };
+
+  } // namespace gch::detail
+
+  //! Debinds the trackers in [first, last), which are about to be destroyed, so that
+  //! destroying them writes to nothing. `proj` maps each element to its tracker. A
+  //! binding between two of the trackers (as in a graph of multireporters) is dropped
+  //! at both ends without writing to either remote, so this is O(V + E) with no random
+  //! writes for those bindings. Bindings with anything else are debound as by `clear`.
+  template <typename ForwardIt, typename Projection = detail::identity_projection>
+  void
+  destroy_all (const ForwardIt first, const ForwardIt last, Projection proj = Projection { })
+  {
+    using tracker_type          = typename std::decay<decltype (proj (*first))>::type;
+    using remote_interface_type = typename tracker_type::remote_interface_type;
+
+    detail::remote_index<ForwardIt, std::allocator<void>> dying;
+    dying.reserve (static_cast<std::size_t> (std::distance (first, last)));
+    for (ForwardIt it = first; it != last; ++it)
+      dying.insert (std::addressof (proj (*it)), it);
+
+    auto is_dying = [&dying](const remote_interface_type& r) noexcept
+                    {
+                      return dying.find (std::addressof (r)) != nullptr;
+                    };
+
+    for (ForwardIt it = first; it != last; ++it)
+      proj (*it).clear_except (is_dying);
+  }
+
 } // namespace gch
 
 #endif
@@ -8,19 +8,14 @@
 #include <unordered_set>
 #include <vector>
 #include <chrono>
-#include <random>
-#include <list>
 #include <sstream>
 #include <array>
+#include <thread>
+#include <deque>
+#include <stdexcept>
 
 using namespace gch;
 
-#ifndef NDEBUG
-constexpr std::size_t multiplier = 1;
-#else
-constexpr std::size_t multiplier = 100;
-#endif
-
 // template <typename Function>
 // struct test_functor
 // {
@@ -1123,116 +1118,6 @@ operator<< (std::ostream& o, const named2& p)
   return o << "}";
 }
 
-template <typename Child, typename Parent>
-static
-std::chrono::duration<double>
-perf_create (void)
-{
-
-  std::cout << "\nperf_create" << std::endl;
-  std::cout <<   "___________" << std::endl;
-
-  using clock = std::chrono::high_resolution_clock;
-  using time = clock::time_point;
-  time t1 = clock::now ();
-
-  Parent p ("p");
-  Parent q ("q");
-  std::list<Child> children;
-  constexpr std::size_t iter_max = 1000 * multiplier;
-
-  for (std::size_t i = 0; i < iter_max; ++i)
-  {
-    children.emplace_back (p.create (std::to_string (i)));
-  }
-
-  auto print_num_children = [&p, &q] (void)
-    {
-      std::cout << p.num_children () << "\n"
-                << q.num_children () << "\n" << std::endl;
-    };
-
-  print_num_children ();
-
-  q.transfer_from (p);
-
-  print_num_children ();
-
-  p.transfer_from (q);
-
-  print_num_children ();
-
-  std::random_device rd;
-  std::mt19937 gen (rd ());
-  std::uniform_real_distribution<double> dist (0.0, 1.0);
-  for (std::size_t i = 0; i < multiplier; ++i)
-    {
-      for (auto it = children.begin (); it != children.end (); )
-      {
-        if (dist (gen) < 0.5 / multiplier)
-          {
-            children.erase (it++);
-            continue;
-          }
-          ++it;
-      }
-    }
-
-  print_num_children ();
-
-  q.transfer_from (p);
-
-  print_num_children ();
-
-  p.transfer_from (q);
-
-  print_num_children ();
-
-  children.clear ();
-
-  time t2 = clock::now ();
-  return std::chrono::duration_cast<std::chrono::duration<double>> (t2 - t1);
-}
-
-template <typename Child, typename Parent>
-static
-std::chrono::duration<double>
-perf_access (void)
-{
-
-  std::cout << "\nperf_access" << std::endl;
-  std::cout <<   "___________" << std::endl;
-
-  using clock = std::chrono::high_resolution_clock;
-  using time = clock::time_point;
-  time t1 = clock::now ();
-
-  Parent p;
-  std::vector<Child> children;
-  constexpr std::size_t iter_max = 1000 * multiplier;
-
-  for (std::size_t i = 0; i < iter_max; ++i)
-    {
-      children.emplace_back (p.create ());
-    }
-
-  std::random_device rd;
-  std::mt19937 gen (rd ());
-  std::uniform_int_distribution<std::size_t> dist (0, 99);
-  for (std::size_t i = 0; i < 10 ; ++i)
-    {
-      for (const Child& r : p)
-        {
-          static_cast<void> (r.f (dist (gen)));
-        }
-    }
-
-  children.clear ();
-
-  time t2 = clock::now ();
-  return std::chrono::duration_cast<std::chrono::duration<double>> (t2 - t1);
-}
-
 static
 std::chrono::duration<double>
 test_multireporter (void)
@@ -1268,107 +1153,6 @@ test_multireporter (void)
   return std::chrono::duration_cast<std::chrono::duration<double>> (t2 - t1);
 }
 
-static
-std::chrono::duration<double>
-perf_multireporter (void)
-{
-
-  std::cout << "\nperf_multireporter" << std::endl;
-  std::cout <<   "__________________" << std::endl;
-
-  using clock = std::chrono::high_resolution_clock;
-  using time = clock::time_point;
-  time t1 = clock::now ();
-  constexpr std::size_t num_iter = 100 * multiplier;
-
-  std::vector<anon_self_parent> objs;
-  objs.reserve (num_iter);
-
-  for (std::size_t i = 0; i < num_iter; ++i)
-    {
-      objs.emplace_back ();
-      auto& b = objs.back ();
-      std::for_each (objs.begin (), --objs.end (),
-                     [&b] (anon_self_parent& a)
-                     {
-                       bind (a, b);
-                     });
-    }
-
-//  objs.emplace_back ();
-//  auto it = objs.begin ();
-//  for (std::size_t i = 0; i < num_iter-1; ++i)
-//    {
-//      objs.emplace_back ();
-//      objs.back ().bind_all (*it++);
-//    }
-
-  std::cout << objs.back () << std::endl;
-
-  std::for_each (objs.begin (), objs.end (),
-                 [] (anon_self_parent& a) { a.clear_tracker (); });
-  objs.clear ();
-
-  time t2 = clock::now ();
-  return std::chrono::duration_cast<std::chrono::duration<double>> (t2 - t1);
-}
-
-static
-std::chrono::duration<double>
-perf_disparate_multireporter (void)
-{
-
-  std::cout << "\nperf_disparate_multireporter" << std::endl;
-  std::cout <<   "____________________________" << std::endl;
-
-  using clock = std::chrono::high_resolution_clock;
-  using time = clock::time_point;
-  time t1 = clock::now ();
-  constexpr std::size_t num_iter = 100 * multiplier;
-
-  std::vector<anon1> a1s;
-  std::vector<anon2> a2s;
-  a1s.reserve (num_iter);
-  a2s.reserve (num_iter);
-
-  for (std::size_t i = 0; i < num_iter; ++i)
-    {
-      a1s.emplace_back ();
-      a2s.emplace_back ();
-      auto& a1 = a1s.back ();
-      auto& a2 = a2s.back ();
-      std::for_each (a2s.begin (), --a2s.end (),
-                     [&a1] (anon2& x2)
-                     {
-                       a1.bind (x2);
-                     });
-
-      std::for_each (a1s.begin (), --a1s.end (),
-                     [&a2] (anon1& x1)
-                     {
-                       a2.bind (x1);
-                     });
-      a1s.back ().bind (a2s.back ());
-    }
-
-  std::cout << a1s.back () << std::endl;
-  std::cout << a2s.back () << std::endl;
-
-  std::for_each (a1s.begin (), a1s.end (),
-                 [] (anon1& a) { a.clear_tracker (); });
-  std::for_each (a2s.begin (), a2s.end (),
-                 [] (anon2& a) { a.clear_tracker (); });
-
-  std::cout << a1s.back () << std::endl;
-  std::cout << a2s.back () << std::endl;
-
-  a1s.clear ();
-  a2s.clear ();
-
-  time t2 = clock::now ();
-  return std::chrono::duration_cast<std::chrono::duration<double>> (t2 - t1);
-}
-
 static
 std::chrono::duration<double>
 test_disparate_multireporter (void)
@@ -1710,146 +1494,1979 @@ test_debinding (void)
 
 // constexpr auto test_debinding_f = make_test_functor ("test debinding\n", &test_debinding);
 
+template <typename Storage>
 static
 void
-test_splicing (void)
+test_relocation (void)
 {
+  using tracker_type  = tracker<int, remote::standalone_reporter, tag::nonintrusive, Storage>;
+  using reporter_type = standalone_reporter<remote::tracker<int, Storage>>;
+
+  constexpr std::size_t num = 40;
+
+  int v = 0;
+  tracker_type tkr (v);
+  std::vector<reporter_type> src (num);
+  for (std::size_t i = 0; i < num; i += 2)
+    src[i].rebind (tkr);
+
+  std::allocator<reporter_type> alloc;
+  reporter_type *dst = alloc.allocate (num);
+  reporter_type *dst_last = relocate_reporters (src.begin (), src.end (), dst);
+  assert (dst_last == dst + num);
+
+  // the originals were destroyed, so give the vector something to destroy
+  for (reporter_type& r : src)
+    ::new (static_cast<void *> (&r)) reporter_type ();
+
+  std::size_t pos = 0;
+  for (auto it = tkr.begin (); it != tkr.end (); ++it, ++pos)
+  {
+    assert (&it.get_remote_interface () == &dst[2 * pos]);
+    assert (dst[2 * pos].get_position () == pos);
+    assert (&dst[2 * pos].get_remote () == &v);
+    assert (! dst[2 * pos + 1].has_remote ());
+  }
+  assert (pos == num / 2);
 
+  for (std::size_t i = 0; i < num; ++i)
+    dst[i].~reporter_type ();
+  alloc.deallocate (dst, num);
+
+  assert (tkr.empty ());
 }
 
 static
 void
-test_range (void)
+test_relocation (void)
 {
-  std::cout << "test range construction" << std::endl;
+  std::cout << "test relocation" << std::endl;
 
-  std::vector<int> data { 3, 5, 7, 5, 5, 8, 2, 7 };
-  std::vector<tracker<int, remote::standalone_tracker>> r;
-  std::transform (data.begin (), data.end (), std::back_inserter (r),
-                  [](int& x) { return tracker<int, remote::standalone_tracker> { x }; });
+  test_relocation<storage::list> ();
+  test_relocation<storage::hashed<>> ();
 
-  std::vector<std::reference_wrapper<tracker<int, remote::standalone_tracker>>> filtered;
-  std::copy_if (r.begin (), r.end (), std::back_inserter (filtered),
-                [](tracker<int, remote::standalone_tracker>& t) { return t.get_parent () == 5; });
+  std::cout << "end" << std::endl;
+}
 
-  standalone_tracker<remote::tracker<int>> tkr { tag::bind, filtered.begin (), filtered.end () };
-  auto print_tkr = [&tkr](void)
+template <typename Storage>
+static
+void
+test_splicing (void)
+{
+  using tracker_type  = tracker<int, remote::standalone_reporter, tag::nonintrusive, Storage>;
+  using reporter_type = standalone_reporter<remote::tracker<int, Storage>>;
+
+  int v = 0;
+  int w = 1;
+  tracker_type agg (v);
+  std::array<reporter_type, 9> rs;
+
+  // agg should hold rs[offset], rs[offset + 1], ...
+  auto check_positions = [&](std::size_t offset)
   {
-    std::cout << "{" << std::endl;
-    std::for_each (tkr.begin (), tkr.end (), [](int& i) { std::cout << "  " << i << std::endl; });
-    std::cout << "}" << std::endl;
+    std::size_t pos = 0;
+    for (auto it = agg.begin (); it != agg.end (); ++it, ++pos)
+    {
+      assert (&it.get_remote_interface () == &rs[offset + pos]);
+      assert (rs[offset + pos].get_position () == pos);
+      assert (&rs[offset + pos].get_remote () == &v);
+    }
+    assert (pos == agg.num_remotes ());
   };
 
-  print_tkr ();
-  // std::vector<tracker<int, remote::standalone_tracker> *> filtered1;
-  // std::for_each (r.begin (), r.end (), [&filtered1](tracker<int, remote::standalone_tracker>& t)
-  //                                      {
-  //                                        if (t.get_parent () == 3)
-  //                                          filtered1.emplace_back (&t);
-  //                                      });
-  // standalone_tracker<remote::tracker<int>> tkr1 { tag::bind, filtered1.begin (), filtered1.end () };
-  filtered.clear ();
-  std::copy_if (r.begin (), r.end (), std::back_inserter (filtered),
-                [](tracker<int, remote::standalone_tracker>& t) { return t.get_parent () == 3; });
+  // splicing an empty tracker leaves everything in place
+  tracker_type empty (w);
+  assert (agg.splice_back (empty) == agg.end ());
+  check_positions (0);
 
-  tkr.bind (filtered.begin (), filtered.end ());
+  // [3, 6) at the back
+  tracker_type part (w);
+  for (std::size_t i = 3; i < 6; ++i)
+    rs[i].rebind (part);
 
-  print_tkr ();
+  auto it = agg.splice_back (part);
+  assert (&it.get_remote_interface () == &rs[3]);
+  assert (part.empty ());
+  check_positions (3);
 
-  filtered.clear ();
-  std::copy_if (r.begin (), r.end (), std::back_inserter (filtered),
-                [](tracker<int, remote::standalone_tracker>& t) { return t.get_parent () == 7; });
+  // [0, 3) at the front
+  for (std::size_t i = 0; i < 3; ++i)
+    rs[i].rebind (part);
 
-  tkr.insert (std::next (tkr.begin ()), filtered.begin (), filtered.end ());
+  it = agg.splice_front (part);
+  assert (&it.get_remote_interface () == &rs[0]);
+  check_positions (0);
+
+  // [6, 9) at the back, but [7, 9) first and then 6 in front of them
+  for (std::size_t i = 7; i < 9; ++i)
+    rs[i].rebind (part);
+
+  it = agg.splice_back (part);
+  assert (&it.get_remote_interface () == &rs[7]);
+
+  rs[6].rebind (part);
+  it = agg.splice (it, part);
+  assert (&it.get_remote_interface () == &rs[6]);
+  check_positions (0);
+}
+
+static
+void
+test_splicing (void)
+{
+  std::cout << "test splicing" << std::endl;
+
+  test_splicing<storage::list> ();
+  test_splicing<storage::small<2>> ();
+  test_splicing<storage::hashed<>> ();
 
-  print_tkr ();
   std::cout << "end" << std::endl;
 }
 
 static
 void
-test_iterators (void)
+test_storage (void)
 {
-  std::cout << "test iterators" << std::endl;
+  std::cout << "test storage" << std::endl;
 
-  std::vector<int> data { 3, 5, 7, 5, 5, 8, 2, 7 };
-  std::vector<tracker<int, remote::standalone_tracker>> r;
-  std::transform (data.begin (), data.end (), std::back_inserter (r),
-                  [](int& x) { return tracker<int, remote::standalone_tracker> { x }; });
+  using list_storage = storage::basic_list<std::list>;
 
-  std::vector<std::reference_wrapper<tracker<int, remote::standalone_tracker>>> filtered;
-  std::copy_if (r.begin (), r.end (), std::back_inserter (filtered),
-                [](tracker<int, remote::standalone_tracker>& t) { return t.get_parent () == 5; });
+  int v = 0;
+  tracker<int, remote::standalone_reporter, tag::nonintrusive, list_storage> tkr (v);
+  standalone_reporter<remote::tracker<int, list_storage>> r1 (tag::bind, tkr);
+  standalone_reporter<remote::tracker<int, list_storage>> r2 (tag::bind, tkr);
 
-  standalone_tracker<remote::tracker<int>> tkr { tag::bind, filtered.begin (), filtered.end () };
+  assert (tkr.num_remotes () == 2);
+  assert (&r1.get_remote () == &v);
 
-  standalone_tracker<remote::tracker<int>>::iter it = tkr.begin ();
-  standalone_tracker<remote::tracker<int>>::citer cit = it;
-  (void)cit;
+  r1.debind ();
+  assert (tkr.num_remotes () == 1);
+  assert (! r1.has_remote ());
+
+  int x = 1;
+  int y = 2;
+  int z = 3;
+  multireporter<int, int, list_storage> tx (x);
+  multireporter<int, int, list_storage> ty (y);
+  multireporter<int, int, list_storage> tz (z);
+
+  tx.bind (ty, tz);
+  assert (tx.num_remotes () == 2);
+  assert (ty.num_remotes () == 1);
+  assert (tx.is_sorted ());
+
+  ty.splice_back (tz);
+  assert (ty.num_remotes () == 2);
+  assert (tz.num_remotes () == 0);
+  assert (tx.num_remotes () == 2);
+
+  tx.clear ();
+  assert (ty.num_remotes () == 0);
 
   std::cout << "end" << std::endl;
 }
 
-class B;
+template <typename Storage>
+static
+void
+test_bulk_bind (void)
+{
+  using tracker_type  = multireporter<int, int, Storage>;
+  using rtracker_type = tracker<int, remote::standalone_reporter, tag::nonintrusive, Storage>;
+  using reporter_type = standalone_reporter<remote::tracker<int, Storage>>;
+
+  int v = 0;
+  std::vector<int> xs (8);
+  std::deque<tracker_type> ts;
+  for (int& x : xs)
+    ts.emplace_back (x);
+
+  tracker_type hub (v);
+  hub.bind (ts[3], ts[6]);
+
+  // interleaved with the existing bindings, in any order
+  std::vector<std::reference_wrapper<tracker_type>> refs { ts[5], ts[0], ts[7], ts[2] };
+  hub.bulk_bind (refs.begin (), refs.end ());
+  hub.bulk_bind ({ ts[1], ts[4] });
+  assert (hub.num_remotes () == 8);
+  assert (hub.is_sorted ());
+  for (tracker_type& t : ts)
+    assert (t.num_remotes () == 1 && hub.contains (t));
+
+  rtracker_type tkr (v);
+  std::array<reporter_type, 4> rs;
+  rs[2].rebind (tkr);
+  tkr.bulk_bind (std::make_move_iterator (rs.begin ()), std::make_move_iterator (rs.end ()));
+  assert (tkr.num_remotes () == 4);
+  assert (tkr.is_sorted ());
+  for (reporter_type& r : rs)
+    assert (&r.get_remote () == &v);
+}
 
-class A
-  : public intrusive_reporter<A, remote::intrusive_tracker<B>>
+static
+void
+test_bulk_bind (void)
 {
-  using base = intrusive_reporter<A, remote::intrusive_tracker<B>>;
+  std::cout << "test bulk bind" << std::endl;
 
-  public:
-    using reporter_type       = base;
-    using remote_tracker_type = typename tracker_traits<reporter_type>::remote_interface_type;
-    using remote_iterator     = remote_tracker_type::citer;
-};
+  test_bulk_bind<storage::list> ();
+  test_bulk_bind<storage::small<2>> ();
+  test_bulk_bind<storage::hashed<>> ();
+  test_bulk_bind<storage::compact<>> ();
+  test_bulk_bind<storage::sorted<>> ();
 
-class B
-  : public intrusive_tracker<B, remote::intrusive_reporter<A>>
-{ };
+  std::cout << "end" << std::endl;
+}
 
-int
-main()
+static
+void
+test_small_storage (void)
 {
-  try
-  {
-    standalone_tracker<remote::intrusive::reporter<mix>> mix_tkr;
-    standalone_reporter<remote::intrusive_tracker<mix>> mix_rptr;
+  std::cout << "test small storage" << std::endl;
 
-    mix mx (mix_tkr, mix_rptr);
-    if (mx.has_remote ())
+  using tracker_type  = small_tracker<int, remote::standalone_reporter, 2>;
+  using reporter_type = standalone_reporter<remote::tracker<int, storage::small<2>>>;
+
+  int v = 0;
+  int w = 1;
+  tracker_type tkr (v);
+
+  // the first two are stored inline, the rest spill to the heap
+  std::array<reporter_type, 4> rs;
+  for (reporter_type& r : rs)
+    r.rebind (tkr);
+
+  auto check_positions = [&rs](const tracker_type& t, int& parent)
+  {
+    std::size_t pos = 0;
+    for (auto it = t.begin (); it != t.end (); ++it, ++pos)
     {
-      mix& rem = mix_rptr.get_remote ();
-      std::cout << rem.num_remotes () << std::endl;
+      assert (&it.get_remote_interface () == &rs[pos]);
+      assert (rs[pos].get_position () == pos);
+      assert (&rs[pos].get_remote () == &parent);
     }
+    assert (pos == t.num_remotes ());
+  };
 
-    test_debinding ();
+  assert (tkr.num_remotes () == 4);
+  check_positions (tkr, v);
 
-    iparent ip ("ip");
-    ichild ic1 (ip.create ("ic1"));
-    ichild ic2 (ip.create ("ic2"));
+  // moving relocates the inline reporters
+  tracker_type moved (std::move (tkr), w);
+  assert (tkr.num_remotes () == 0);
+  check_positions (moved, w);
 
-    std::cout << test_reporter<child, parent> ().count () << std::endl;
-    std::cout << test_reporter<nonintruded_child_s, nonintruded_parent_s> ().count () << std::endl;
+  tracker_type other (v);
+  other.splice_back (moved);
+  check_positions (other, v);
 
-    std::cout << perf_create<ichild, iparent> ().count () << std::endl;
-    std::cout << perf_create<child, parent> ().count () << std::endl;
-    std::cout << perf_create<nonintruded_child, nonintruded_parent> ().count () << std::endl;
+  rs[0].debind ();
+  rs[3].debind ();
+  assert (other.num_remotes () == 2);
+  assert (&other.front () == &rs[1]);
 
-    std::cout << perf_access<child, parent> ().count () << std::endl;
-    std::cout << perf_access<nonintruded_child, nonintruded_parent> ().count () << std::endl;
+  moved.transfer_back (other, other.begin (), other.end ());
+  assert (other.num_remotes () == 0);
+  assert (moved.num_remotes () == 2);
+  assert (rs[1].get_position () == 0);
+  assert (rs[2].get_position () == 1);
+  assert (&rs[2].get_remote () == &w);
 
+  moved.clear ();
+  assert (! rs[1].has_remote ());
+  assert (! rs[2].has_remote ());
 
-    plf::list<int> x = {1, 2, 3, 4};
-    plf::list<int>::iterator last = --x.end ();
-    std::reverse_iterator<plf::list<int>::iterator> rb (x.end ());
-    std::cout << (*last == *rb) << std::endl;
+  std::cout << "end" << std::endl;
+}
 
-    test_multireporter ();
+template <typename Storage>
+static
+void
+test_hashed_storage (void)
+{
+  using tracker_type  = multireporter<int, int, Storage>;
+  using rtracker_type = tracker<int, remote::standalone_reporter, tag::nonintrusive, Storage>;
+  using reporter_type = standalone_reporter<remote::tracker<int, Storage>>;
+
+  int x = 1;
+  int y = 2;
+  int z = 3;
+  tracker_type tx (x);
+  tracker_type ty (y);
+  tracker_type tz (z);
+
+  tx.bind (ty, tz);
+  ty.bind (tz);
+  tx.bind (ty);
+
+  assert (tx.contains (ty));
+  assert (tx.contains (tz));
+  assert (! tx.contains (tx));
+  assert (&*tx.find (tz) == &z);
+  assert (tz.find (tz) == tz.end ());
+
+  // moving a remote re-keys the bindings held by the other trackers
+  tracker_type tw (std::move (tz), z);
+  assert (! tx.contains (tz) && ! ty.contains (tz));
+  assert (tx.contains (tw) && ty.contains (tw));
+  assert (tw.contains (tx) && tw.contains (ty));
+
+  // ty and tw are bound to each other
+  ty.swap (tw);
+  assert (tx.contains (ty) && tx.contains (tw));
+  assert (ty.contains (tw) && tw.contains (ty));
+  assert (ty.num_remotes () == 2 && tw.num_remotes () == 3);
+
+  tw.splice_back (tz);
+  tz.splice_back (ty);
+  assert (tz.contains (tx) && tz.contains (tw));
+  assert (tx.contains (tz) && tw.contains (tz));
+  assert (! tx.contains (ty) && ! tw.contains (ty));
+
+  tx.debind (tw);
+  assert (! tx.contains (tw) && ! tw.contains (tx));
+  assert (tx.num_remotes () == 1 && tw.num_remotes () == 1);
+
+  tx.debind (tz);
+  assert (tx.empty () && tz.num_remotes () == 1);
+
+  int v = 0;
+  rtracker_type tkr (v);
+  std::array<reporter_type, 4> rs;
+  for (reporter_type& r : rs)
+    r.rebind (tkr);
+
+  for (const reporter_type& r : rs)
+    assert (tkr.contains (r));
+
+  // moving a reporter re-keys its binding
+  reporter_type moved (std::move (rs[1]));
+  assert (tkr.contains (moved));
+  assert (! tkr.contains (rs[1]));
+
+  rs[2].swap (moved);
+  assert (tkr.contains (rs[2]) && tkr.contains (moved));
+
+  tkr.debind (rs[0]);
+  assert (! rs[0].has_remote ());
+  assert (! tkr.contains (rs[0]));
+  assert (tkr.num_remotes () == 3);
+
+  rtracker_type other (std::move (tkr), v);
+  assert (other.contains (rs[2]) && other.contains (rs[3]) && other.contains (moved));
+}
 
-//      std::cout << "got back" << std::endl;
+static
+void
+test_hashed_storage (void)
+{
+  std::cout << "test hashed storage" << std::endl;
+
+  test_hashed_storage<storage::hashed<>> ();
+  test_hashed_storage<storage::hashed<storage::small<2>>> ();
+  test_hashed_storage<storage::hashed<storage::indexed<>>> ();
+
+  std::cout << "end" << std::endl;
+}
+
+template <typename Storage>
+static
+void
+test_concurrent_storage (void)
+{
+  using tracker_type  = multireporter<int, int, Storage>;
+  using rtracker_type = tracker<int, remote::standalone_reporter, tag::nonintrusive, Storage>;
+  using reporter_type = standalone_reporter<remote::tracker<int, Storage>>;
+
+  constexpr std::size_t num_threads = 4;
+  constexpr std::size_t num_rounds  = 200;
+
+  int v = 0;
+  rtracker_type tkr (v);
+  rtracker_type other (v);
+
+  int h = 0;
+  tracker_type hub (h);
+
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < num_threads; ++i)
+  {
+    threads.emplace_back ([&]
+                          {
+                            int x = 0;
+                            tracker_type own (x);
+                            for (std::size_t j = 0; j < num_rounds; ++j)
+                            {
+                              std::array<reporter_type, 4> rs;
+                              for (reporter_type& r : rs)
+                                r.rebind (tkr);
+
+                              reporter_type bound (tag::bind, tkr);
+                              reporter_type moved (std::move (rs[0]));
+                              rs[1].rebind (other);
+                              rs[2].debind ();
+
+                              own.push_back (hub);
+                              own.bind (hub);
+                              own.debind (hub);
+                            }
+                          });
+  }
+
+  for (std::thread& t : threads)
+    t.join ();
+
+  assert (tkr.empty ());
+  assert (other.empty ());
+  assert (hub.empty ());
+}
+
+static
+void
+test_concurrent_storage (void)
+{
+  std::cout << "test concurrent storage" << std::endl;
+
+  test_concurrent_storage<storage::concurrent<>> ();
+  test_concurrent_storage<storage::concurrent<storage::hashed<>>> ();
 
-    std::cout << perf_multireporter ().count () << std::endl;
-    std::cout << perf_disparate_multireporter ().count () << std::endl;
+  std::cout << "end" << std::endl;
+}
+
+template <typename Storage>
+static
+void
+test_tombstoned_storage (void)
+{
+  using tracker_type  = multireporter<int, int, Storage>;
+  using rtracker_type = tracker<int, remote::standalone_reporter, tag::nonintrusive, Storage>;
+  using reporter_type = standalone_reporter<remote::tracker<int, Storage>>;
+
+  int v = 0;
+  rtracker_type tkr (v);
+  std::array<reporter_type, 4> rs;
+  for (reporter_type& r : rs)
+    r.rebind (tkr);
+
+  {
+    reporter_type r0 (tag::bind, tkr);
+    reporter_type r1 (tag::bind, tkr);
+    assert (tkr.num_remotes () == 6);
+  }
+
+  // dead reporters are not counted or visited, and don't affect positions
+  assert (tkr.num_remotes () == 4);
+  assert (std::distance (tkr.begin (), tkr.end ()) == 4);
+  for (std::size_t i = 0; i < rs.size (); ++i)
+    assert (rs[i].get_position () == i);
+
+  rs[1].debind ();
+  assert (rs[2].get_position () == 1);
+  rs[1].rebind (tkr);
+  assert (rs[1].get_position () == 3);
+
+  reporter_type moved (std::move (rs[3]));
+  rtracker_type other (std::move (tkr), v);
+  assert (other.num_remotes () == 4);
+  assert (other.contains (moved) && moved.get_position () == 2);
+
+  {
+    reporter_type r (tag::bind, other);
+  }
+  other.compact ();
+  assert (other.num_remotes () == 4);
+
+  int x = 1;
+  int y = 2;
+  tracker_type tx (x);
+  {
+    tracker_type ty (y);
+    tx.bind (ty);
+    ty.bind (tx);
+    assert (tx.num_remotes () == 2);
+  }
+  assert (tx.empty ());
+}
+
+static
+void
+test_tombstoned_storage (void)
+{
+  std::cout << "test tombstoned storage" << std::endl;
+
+  test_tombstoned_storage<storage::tombstoned<>> ();
+  test_tombstoned_storage<storage::tombstoned<storage::small<2>>> ();
+  test_tombstoned_storage<storage::tombstoned<storage::indexed<>>> ();
+  test_tombstoned_storage<storage::concurrent<storage::tombstoned<>>> ();
+
+  test_concurrent_storage<storage::concurrent<storage::tombstoned<>>> ();
+
+  std::cout << "end" << std::endl;
+}
+
+template <typename Storage>
+static
+void
+test_concurrent_iteration (void)
+{
+  using rtracker_type = tracker<int, remote::standalone_reporter, tag::nonintrusive, Storage>;
+  using reporter_type = standalone_reporter<remote::tracker<int, Storage>>;
+
+  constexpr std::size_t num_threads = 2;
+  constexpr std::size_t num_rounds  = 200;
+
+  int v = 0;
+  rtracker_type tkr (v);
+  std::array<reporter_type, 3> fixed;
+  for (reporter_type& r : fixed)
+    r.rebind (tkr);
+
+  std::size_t count = 0;
+  tkr.for_each_remote ([&count](const reporter_type&) { ++count; });
+  assert (count == fixed.size ());
+
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < num_threads; ++i)
+  {
+    threads.emplace_back ([&]
+                          {
+                            for (std::size_t j = 0; j < num_rounds; ++j)
+                            {
+                              std::array<reporter_type, 4> rs;
+                              for (reporter_type& r : rs)
+                                r.rebind (tkr);
+                            }
+                          });
+
+    threads.emplace_back ([&]
+                          {
+                            for (std::size_t j = 0; j < num_rounds; ++j)
+                            {
+                              std::size_t n = 0;
+                              tkr.for_each_remote ([&n](const reporter_type& r)
+                                                   {
+                                                     n += r.has_remote ();
+                                                   });
+                              assert (n >= fixed.size ());
+                            }
+                          });
+  }
+
+  for (std::thread& t : threads)
+    t.join ();
+
+  assert (tkr.num_remotes () == fixed.size ());
+}
+
+static
+void
+test_concurrent_iteration (void)
+{
+  std::cout << "test concurrent iteration" << std::endl;
+
+  test_concurrent_iteration<storage::concurrent<>> ();
+  test_concurrent_iteration<storage::concurrent<storage::tombstoned<>>> ();
+  test_concurrent_iteration<storage::concurrent<storage::tombstoned<storage::small<2>>>> ();
+
+  std::cout << "end" << std::endl;
+}
+
+struct test_arena
+{
+  std::size_t num_allocated = 0;
+};
+
+// a stateful allocator which is not propagated on move assignment
+template <typename T>
+struct arena_allocator
+{
+  using value_type = T;
+  using propagate_on_container_move_assignment = std::false_type;
+
+  explicit
+  arena_allocator (test_arena& arena) noexcept
+    : m_arena (&arena)
+  { }
+
+  template <typename U>
+  arena_allocator (const arena_allocator<U>& other) noexcept
+    : m_arena (other.m_arena)
+  { }
+
+  T *
+  allocate (std::size_t n)
+  {
+    m_arena->num_allocated += n;
+    return std::allocator<T> { }.allocate (n);
+  }
+
+  void
+  deallocate (T *p, std::size_t n) noexcept
+  {
+    std::allocator<T> { }.deallocate (p, n);
+  }
+
+  friend
+  bool
+  operator== (const arena_allocator& lhs, const arena_allocator& rhs) noexcept
+  {
+    return lhs.m_arena == rhs.m_arena;
+  }
+
+  friend
+  bool
+  operator!= (const arena_allocator& lhs, const arena_allocator& rhs) noexcept
+  {
+    return ! (lhs == rhs);
+  }
+
+  test_arena *m_arena;
+};
+
+template <typename Storage, typename Allocator>
+static
+void
+test_allocators (Allocator alloc1, Allocator alloc2)
+{
+  using tracker_type  = multireporter<int, int, Storage>;
+  using rtracker_type = tracker<int, remote::standalone_reporter, tag::nonintrusive, Storage>;
+  using reporter_type = standalone_reporter<remote::tracker<int, Storage>>;
+
+  int v = 0;
+  rtracker_type t1 (v, alloc1);
+  std::array<reporter_type, 3> rs;
+  for (reporter_type& r : rs)
+    r.rebind (t1);
+  assert (Allocator (t1.get_allocator ()) == alloc1);
+
+  // moves take the allocator along with the nodes
+  rtracker_type t2 (std::move (t1), v);
+  assert (Allocator (t2.get_allocator ()) == alloc1);
+  assert (t2.num_remotes () == 3);
+
+  // splicing into a tracker with another allocator copies the reporters over
+  rtracker_type t3 (v, alloc2);
+  reporter_type r3 (tag::bind, t3);
+  t3.splice (t3.begin (), t2);
+  assert (Allocator (t3.get_allocator ()) == alloc2);
+  assert (t2.empty () && t3.num_remotes () == 4);
+  for (std::size_t i = 0; i < rs.size (); ++i)
+    assert (t3.contains (rs[i]) && rs[i].get_position () == i);
+  assert (r3.get_position () == 3);
+
+  // each tracker keeps its allocator when swapped
+  reporter_type r2 (tag::bind, t2);
+  t2.swap (t3);
+  assert (Allocator (t2.get_allocator ()) == alloc1 && Allocator (t3.get_allocator ()) == alloc2);
+  assert (t2.num_remotes () == 4 && t3.num_remotes () == 1);
+  assert (t2.contains (rs[0]) && t3.contains (r2));
+  assert (r3.get_position () == 3 && r2.get_position () == 0);
+
+  int x = 1;
+  int y = 2;
+  int z = 3;
+  tracker_type tx (x, alloc1);
+  tracker_type ty (y, alloc2);
+  tracker_type tz (z, alloc2);
+  tx.bind (tz);
+  ty.bind (tz);
+
+  tx.merge (ty);
+  assert (ty.empty () && tx.num_remotes () == 2);
+  assert (tx.is_sorted ());
+  assert (tz.num_remotes () == 2 && tz.front () == x && tz.back () == x);
+
+  tx.clear ();
+  assert (tz.empty ());
+}
+
+static
+void
+test_allocators (void)
+{
+  std::cout << "test allocators" << std::endl;
+
+  test_arena a1;
+  test_arena a2;
+  arena_allocator<void> alloc1 (a1);
+  arena_allocator<void> alloc2 (a2);
+
+  using list_storage = storage::basic_list<plf::list, arena_allocator<void>>;
+  test_allocators<list_storage> (alloc1, alloc2);
+  test_allocators<storage::small<1, arena_allocator<void>>> (alloc1, alloc2);
+  test_allocators<storage::hashed<list_storage>> (alloc1, alloc2);
+  test_allocators<storage::tombstoned<storage::indexed<list_storage>>> (alloc1, alloc2);
+  assert (a1.num_allocated != 0 && a2.num_allocated != 0);
+
+#ifdef GCH_LIB_MEMORY_RESOURCE
+  std::array<std::byte, 4096> buf1;
+  std::array<std::byte, 4096> buf2;
+  std::pmr::monotonic_buffer_resource res1 (buf1.data (), buf1.size (),
+                                            std::pmr::null_memory_resource ());
+  std::pmr::monotonic_buffer_resource res2 (buf2.data (), buf2.size (),
+                                            std::pmr::null_memory_resource ());
+
+  using pmr_alloc = std::pmr::polymorphic_allocator<std::byte>;
+  test_allocators<storage::pmr::list> (pmr_alloc (&res1), pmr_alloc (&res2));
+  test_allocators<storage::pmr::small<2>> (pmr_alloc (&res1), pmr_alloc (&res2));
+#endif
+
+  std::cout << "end" << std::endl;
+}
+
+template <typename Storage, typename Scope>
+static
+void
+test_pooled_storage (void)
+{
+  using tracker_type  = tracker<int, remote::standalone_reporter, tag::nonintrusive, Storage>;
+  using reporter_type = standalone_reporter<remote::tracker<int, Storage>>;
+
+  trim_pools<Scope> ();
+  const pool_stats before = get_pool_stats<Scope> ();
+  assert (before.num_cached == 0 && before.bytes_cached == 0);
+
+  int v = 0;
+  std::array<reporter_type, 4> rs;
+  {
+    tracker_type tkr (v);
+    for (reporter_type& r : rs)
+      r.rebind (tkr);
+    assert (get_pool_stats<Scope> ().num_in_use > before.num_in_use);
+  }
+
+  // the blocks of the destroyed tracker are reused by the next one
+  const pool_stats freed = get_pool_stats<Scope> ();
+  assert (freed.num_in_use == before.num_in_use);
+  assert (freed.num_cached != 0 && freed.bytes_cached != 0);
+
+  {
+    tracker_type tkr (v);
+    tracker_type other (v);
+    for (reporter_type& r : rs)
+      r.rebind (tkr);
+    other.splice (other.end (), tkr);
+    assert (other.num_remotes () == 4 && rs[3].get_position () == 3);
+
+    const pool_stats reused = get_pool_stats<Scope> ();
+    assert (reused.num_reused > freed.num_reused);
+    assert (reused.num_fresh == freed.num_fresh);
+  }
+
+  trim_pools<Scope> ();
+  assert (get_pool_stats<Scope> ().num_cached == 0);
+}
+
+static
+void
+test_pooled_storage (void)
+{
+  std::cout << "test pooled storage" << std::endl;
+
+  using small_storage = storage::small<1, pool_allocator<void>>;
+  test_pooled_storage<storage::pooled<>, pool_scope::global> ();
+  test_pooled_storage<small_storage, pool_scope::global> ();
+
+  std::thread t (test_pooled_storage<storage::pooled<pool_scope::thread>, pool_scope::thread>);
+  t.join ();
+
+  std::cout << "end" << std::endl;
+}
+
+template <typename Storage>
+static
+void
+test_compact_storage (void)
+{
+  using tracker_type  = multireporter<int, int, Storage>;
+  using rtracker_type = tracker<int, remote::standalone_reporter, tag::nonintrusive, Storage>;
+  using reporter_type = standalone_reporter<remote::tracker<int, Storage>>;
+
+  int v = 0;
+  int w = 1;
+  rtracker_type tkr (v);
+  std::array<reporter_type, 4> rs;
+  for (reporter_type& r : rs)
+    r.rebind (tkr);
+
+  auto check_positions = [&rs](const rtracker_type& t, int& parent)
+  {
+    std::size_t pos = 0;
+    for (auto it = t.begin (); it != t.end (); ++it, ++pos)
+    {
+      assert (&it.get_remote_interface () == &rs[pos]);
+      assert (rs[pos].get_position () == pos);
+      assert (&rs[pos].get_remote () == &parent);
+    }
+    assert (pos == t.num_remotes ());
+  };
+
+  assert (tkr.num_remotes () == 4);
+  check_positions (tkr, v);
+
+  // freed slots are reused
+  rs[1].debind ();
+  assert (tkr.num_remotes () == 3 && rs[2].get_position () == 1);
+  rs[1].rebind (tkr);
+  assert (rs[1].get_position () == 3);
+  std::swap (rs[1], rs[3]);
+  std::swap (rs[1], rs[2]);
+  check_positions (tkr, v);
+
+  // handles go stale when their binding is erased, even if the slot is reused
+  const tracker_handle h0 = tkr.get_handle (tkr.begin ());
+  const tracker_handle h1 = tkr.get_handle (std::next (tkr.begin ()));
+  assert (tkr.is_valid (h0) && tkr.is_valid (h1));
+  assert (&tkr.find (h1).get_remote_interface () == &rs[1]);
+  rs[1].debind ();
+  assert (tkr.is_valid (h0) && ! tkr.is_valid (h1));
+  rs[1].rebind (tkr);
+  assert (! tkr.is_valid (h1) && tkr.find (h1) == tkr.end ());
+  rs[1].debind ();
+  rs[1].rebind (tkr);
+  std::swap (rs[1], rs[3]);
+  std::swap (rs[1], rs[2]);
+  assert (tkr.is_valid (tkr.get_handle (std::next (tkr.begin ()))));
+
+  // the moved tracker gets a new id, and the reporters follow it
+  rtracker_type moved (std::move (tkr), w);
+  assert (! tkr.is_valid (h0) && ! moved.is_valid (tracker_handle { }));
+  assert (tkr.num_remotes () == 0);
+  check_positions (moved, w);
+
+  rtracker_type other (v);
+  reporter_type r (tag::bind, other);
+  other.splice (other.begin (), moved);
+  assert (moved.empty () && other.num_remotes () == 5);
+  assert (r.get_position () == 4);
+  r.debind ();
+  check_positions (other, v);
+
+  int x = 1;
+  int y = 2;
+  int z = 3;
+  tracker_type tx (x);
+  tracker_type ty (y);
+  {
+    tracker_type tz (z);
+    tx.bind (ty, tz);
+    assert (tx.num_remotes () == 2 && ty.num_remotes () == 1);
+    assert (tx.is_sorted ());
+  }
+  assert (tx.num_remotes () == 1);
+
+  tracker_type tmoved (std::move (ty), y);
+  assert (&tx.front () == &y);
+  assert (tmoved.num_remotes () == 1 && &tmoved.front () == &x);
+}
+
+static
+void
+test_compact_storage (void)
+{
+  std::cout << "test compact storage" << std::endl;
+
+  using list_reporter    = standalone_reporter<remote::tracker<int>>;
+  using compact_reporter = standalone_reporter<remote::tracker<int, storage::compact<>>>;
+  static_assert (sizeof (compact_reporter) < sizeof (list_reporter),
+                 "compact reporters should be smaller");
+
+  test_compact_storage<storage::compact<>> ();
+  test_compact_storage<storage::concurrent<storage::compact<>>> ();
+
+  test_concurrent_storage<storage::concurrent<storage::compact<>>> ();
+
+  std::cout << "end" << std::endl;
+}
+
+template <typename Storage>
+static
+void
+test_indexed_storage (void)
+{
+  using tracker_type  = tracker<int, remote::standalone_reporter, tag::nonintrusive, Storage>;
+  using reporter_type = standalone_reporter<remote::tracker<int, Storage>>;
+
+  int v = 0;
+  tracker_type tkr (v);
+  std::array<reporter_type, 8> rs;
+
+  auto check_positions = [&tkr](void)
+  {
+    std::size_t pos = 0;
+    for (auto it = tkr.begin (); it != tkr.end (); ++it, ++pos)
+    {
+      assert (it.get_remote_interface ().get_position () == pos);
+      assert (tkr.get_offset (it) == pos);
+    }
+    assert (tkr.get_offset (tkr.end ()) == tkr.num_remotes ());
+  };
+
+  for (std::size_t i = 0; i < rs.size (); ++i)
+  {
+    if (i % 2 == 0)
+      rs[i].rebind (tkr);
+    else
+      tkr.insert (tkr.begin (), std::move (rs[i]));
+    check_positions ();
+  }
+
+  tkr.erase (std::next (tkr.begin (), 3));
+  check_positions ();
+
+  tkr.pop_back ();
+  check_positions ();
+
+  tracker_type other (v);
+  std::array<reporter_type, 3> os;
+  for (reporter_type& r : os)
+    r.rebind (other);
+
+  tkr.splice (std::next (tkr.begin ()), other);
+  check_positions ();
+}
+
+static
+void
+test_indexed_storage (void)
+{
+  std::cout << "test indexed storage" << std::endl;
+
+  test_indexed_storage<storage::indexed<>> ();
+  test_indexed_storage<storage::indexed<storage::small<2>>> ();
+
+  std::cout << "end" << std::endl;
+}
+
+template <typename Storage>
+static
+void
+test_capacity (void)
+{
+  using tracker_type  = multireporter<int, int, Storage>;
+  using rtracker_type = tracker<int, remote::standalone_reporter, tag::nonintrusive, Storage>;
+  using reporter_type = standalone_reporter<remote::tracker<int, Storage>>;
+
+  int v = 0;
+  rtracker_type tkr (v);
+  tkr.reserve (8);
+  assert (tkr.capacity () >= 8);
+
+  std::array<reporter_type, 8> rs;
+  for (reporter_type& r : rs)
+    r.rebind (tkr);
+  assert (tkr.num_remotes () == 8 && tkr.capacity () >= 8);
+
+  for (std::size_t i = 0; i < rs.size (); i += 2)
+    rs[i].debind ();
+  tkr.trim ();
+  assert (tkr.num_remotes () == 4);
+
+  // the remaining bindings may have moved, and are followed by their reporters
+  tkr.shrink_to_fit ();
+  assert (tkr.num_remotes () == 4 && tkr.capacity () >= 4);
+  std::size_t pos = 0;
+  for (auto it = tkr.begin (); it != tkr.end (); ++it, ++pos)
+  {
+    assert (&it.get_remote_interface () == &rs[2 * pos + 1]);
+    assert (rs[2 * pos + 1].get_position () == pos);
+    assert (&rs[2 * pos + 1].get_remote () == &v);
+  }
+  rs[3].debind ();
+  assert (tkr.num_remotes () == 3 && rs[5].get_position () == 1);
+
+  tkr.clear ();
+  tkr.shrink_to_fit ();
+  rs[0].rebind (tkr);
+  assert (tkr.num_remotes () == 1 && rs[0].get_position () == 0);
+
+  int x = 1;
+  int y = 2;
+  int z = 3;
+  tracker_type tx (x);
+  tracker_type ty (y);
+  tracker_type tz (z);
+  tx.reserve (2);
+  tx.bind (ty, tz);
+  ty.debind (tx);
+  tx.shrink_to_fit ();
+  assert (tx.num_remotes () == 1 && &tx.front () == &z);
+  assert (tz.num_remotes () == 1 && &tz.front () == &x);
+  tz.clear ();
+  assert (tx.empty ());
+}
+
+static
+void
+test_capacity (void)
+{
+  std::cout << "test capacity" << std::endl;
+
+  test_capacity<storage::list> ();
+  test_capacity<storage::small<2>> ();
+  test_capacity<storage::indexed<>> ();
+  test_capacity<storage::hashed<>> ();
+  test_capacity<storage::tombstoned<>> ();
+  test_capacity<storage::compact<>> ();
+  test_capacity<storage::sorted<>> ();
+
+  // spare nodes are kept, so binding up to the reserved capacity doesn't allocate
+  test_arena arena;
+  arena_allocator<void> alloc (arena);
+  using small_storage = storage::small<1, arena_allocator<void>>;
+  int v = 0;
+  tracker<int, remote::standalone_reporter, tag::nonintrusive, small_storage> tkr (v, alloc);
+  tkr.reserve (4);
+  const std::size_t num_allocated = arena.num_allocated;
+  {
+    std::array<standalone_reporter<remote::tracker<int, small_storage>>, 4> rs;
+    for (auto& r : rs)
+      r.rebind (tkr);
+  }
+  assert (tkr.empty () && tkr.capacity () == 4);
+  assert (arena.num_allocated == num_allocated);
+  tkr.shrink_to_fit ();
+  assert (tkr.capacity () == 1);
+
+  std::cout << "end" << std::endl;
+}
+
+// the remotes of `t` must be in order of address
+template <typename Tracker>
+static
+void
+assert_ordered_by_remote (Tracker& t)
+{
+  assert (t.is_sorted ());
+  const void *prev = nullptr;
+  for (auto it = t.begin (); it != t.end (); ++it)
+  {
+    const void *curr = &it.get_remote_interface ();
+    assert (prev == nullptr || ! std::less<const void *> { } (curr, prev));
+    prev = curr;
+  }
+}
+
+template <typename Storage>
+static
+void
+test_sorted_storage (void)
+{
+  using tracker_type  = multireporter<int, int, Storage>;
+  using rtracker_type = tracker<int, remote::standalone_reporter, tag::nonintrusive, Storage>;
+  using reporter_type = standalone_reporter<remote::tracker<int, Storage>>;
+
+  int v = 0;
+  int w = 1;
+  rtracker_type tkr (v);
+  std::array<reporter_type, 6> rs;
+
+  // bound in reverse, both one at a time and as a range
+  for (std::size_t i = 3; i-- > 0;)
+    rs[i].rebind (tkr);
+  tkr.bind (std::make_move_iterator (rs.rbegin ()), std::make_move_iterator (rs.rbegin () + 3));
+  assert_ordered_by_remote (tkr);
+  for (std::size_t i = 0; i < rs.size (); ++i)
+    assert (rs[i].get_position () == i);
+
+  // moving a reporter may put it out of order until the next insertion
+  reporter_type moved (std::move (rs[2]));
+  assert (tkr.contains (moved) && ! tkr.contains (rs[2]));
+  rs[2].rebind (tkr);
+  assert_ordered_by_remote (tkr);
+  assert (tkr.num_remotes () == 7);
+  moved.debind ();
+
+  rtracker_type other (w);
+  rs[3].rebind (other);
+  rs[1].rebind (other);
+  tkr.merge (other);
+  assert (other.empty ());
+  assert_ordered_by_remote (tkr);
+
+  // transfers and splices merge the reporters in wherever they are placed
+  other.transfer (other.cend (), tkr, tkr.cbegin (), std::next (tkr.cbegin (), 3));
+  assert_ordered_by_remote (other);
+  assert (other.num_remotes () == 3 && &rs[2].get_remote () == &w);
+  tkr.splice_front (other);
+  assert_ordered_by_remote (tkr);
+  for (std::size_t i = 0; i < rs.size (); ++i)
+    assert (rs[i].get_position () == i && &rs[i].get_remote () == &v);
+
+  std::vector<int> xs (6);
+  std::deque<tracker_type> ts;
+  for (int& x : xs)
+    ts.emplace_back (x);
+
+  tracker_type hub (v);
+  hub.bind (ts[5], ts[0], ts[3]);
+  ts[2].bind (hub);
+  assert_ordered_by_remote (hub);
+
+  tracker_type ts0 (std::move (ts[0]), xs[0]);
+  assert (hub.contains (ts0) && ! hub.contains (ts[0]));
+  hub.bind (ts[1]);
+  assert_ordered_by_remote (hub);
+
+  tracker_type hub2 (w);
+  hub2.bind (ts[4], ts[2]);
+  hub.merge (hub2);
+  assert_ordered_by_remote (hub);
+  assert (hub.num_remotes () == 7 && ts[2].num_remotes () == 2);
+
+  hub.debind (ts[2]);
+  assert (hub.num_remotes () == 5 && ts[2].empty ());
+  assert_ordered_by_remote (hub);
+}
+
+static
+void
+test_sorted_storage (void)
+{
+  std::cout << "test sorted storage" << std::endl;
+
+  test_sorted_storage<storage::sorted<>> ();
+  test_sorted_storage<storage::sorted<storage::small<2>>> ();
+  test_sorted_storage<storage::sorted<storage::indexed<>>> ();
+  test_sorted_storage<storage::concurrent<storage::sorted<>>> ();
+
+  std::cout << "end" << std::endl;
+}
+
+template <typename Storage>
+static
+void
+test_instrumented_storage (void)
+{
+  using tracker_type  = multireporter<int, int, Storage>;
+  using rtracker_type = tracker<int, remote::standalone_reporter, tag::nonintrusive, Storage>;
+  using reporter_type = standalone_reporter<remote::tracker<int, Storage>>;
+
+  reset_tracker_stats ();
+
+  int v = 0;
+  rtracker_type tkr (v);
+  std::array<reporter_type, 4> rs;
+  for (reporter_type& r : rs)
+    r.rebind (tkr);
+
+  tracker_stats s = get_tracker_stats<rtracker_type> ();
+  assert (s.num_binds == 4 && s.num_debinds == 0 && s.num_allocations >= 1);
+
+  reporter_type moved (std::move (rs[0]));
+  rs[1].debind ();
+  s = get_tracker_stats<rtracker_type> ();
+  assert (s.num_moves == 1 && s.num_debinds == 1 && s.num_remote_writes == 0);
+
+  // moving the tracker points each of the reporters at the new one
+  rtracker_type other (std::move (tkr), v);
+  s = get_tracker_stats<rtracker_type> ();
+  assert (s.num_repoints == 3 && s.num_remote_writes == 3);
+
+  other.clear ();
+  s = get_tracker_stats<rtracker_type> ();
+  assert (s.num_debinds == 4 && s.num_remote_writes == 6);
+
+  // both ends of a binding between trackers are counted
+  int x = 1;
+  int y = 2;
+  tracker_type tx (x);
+  tracker_type ty (y);
+  tx.bind (ty);
+  tx.debind (ty);
+  s = get_tracker_stats<tracker_type> ();
+  assert (s.num_binds == 2 && s.num_debinds == 2 && s.num_remote_writes == 1);
+
+  std::ostringstream text;
+  write_tracker_stats (text);
+  assert (text.str ().find ("binds=4 debinds=4 repoints=3 moves=1 remote_writes=6") != std::string::npos);
+  std::cout << text.str ();
+
+  std::ostringstream json;
+  write_tracker_stats_json (json);
+  assert (json.str ().front () == '[');
+  assert (json.str ().find ("\"binds\":2,\"debinds\":2") != std::string::npos);
+}
+
+static
+void
+test_instrumented_storage (void)
+{
+  std::cout << "test instrumented storage" << std::endl;
+
+  test_instrumented_storage<storage::instrumented<>> ();
+  test_instrumented_storage<storage::instrumented<storage::small<2>>> ();
+  test_instrumented_storage<storage::concurrent<storage::instrumented<storage::sorted<>>>> ();
+
+  std::cout << "end" << std::endl;
+}
+
+template <typename Storage>
+struct hooked_tracker;
+
+// told when its tracker drops it
+template <typename Storage>
+struct hooked_reporter
+{
+  using reporter_type = reporter<hooked_reporter, remote::intrusive_tracker<hooked_tracker<Storage>,
+                                                                            Storage>>;
+
+  hooked_reporter (void)
+    : rptr (*this)
+  { }
+
+  void
+  on_debind (reporter_type& r) noexcept
+  {
+    assert (&r == &rptr && ! r.has_remote ());
+    ++num_debinds;
+  }
+
+  reporter_type rptr;
+  int           num_debinds = 0;
+};
+
+// told when a reporter leaves it for another tracker, or joins it
+template <typename Storage>
+struct hooked_tracker
+  : tracker<hooked_tracker<Storage>, remote::reporter<hooked_reporter<Storage>>, tag::intrusive,
+            Storage>
+{
+  using tracker_type = tracker<hooked_tracker, remote::reporter<hooked_reporter<Storage>>,
+                               tag::intrusive, Storage>;
+
+  void
+  on_debind (tracker_type&) noexcept
+  {
+    ++num_debinds;
+  }
+
+  void
+  on_rebind (tracker_type&) noexcept
+  {
+    ++num_rebinds;
+  }
+
+  int num_debinds = 0;
+  int num_rebinds = 0;
+};
+
+template <typename Storage>
+static
+void
+test_debind_hooks (void)
+{
+  using reporter_type = typename hooked_reporter<Storage>::reporter_type;
+  using tracker_type  = typename hooked_tracker<Storage>::tracker_type;
+
+  static_assert (detail::has_debind_hook<reporter_type>::value, "missing hook");
+  static_assert (! detail::has_rebind_hook<reporter_type>::value, "unexpected hook");
+  static_assert (detail::has_rebind_hook<tracker_type>::value, "missing hook");
+  static_assert (! detail::has_debind_hook<tracker<int, remote::reporter<int>>>::value,
+                 "unexpected hook");
+
+  hooked_tracker<Storage> a;
+  hooked_tracker<Storage> b;
+  std::array<hooked_reporter<Storage>, 3> rs;
+
+  for (hooked_reporter<Storage>& r : rs)
+    r.rptr.rebind (a);
+  assert (a.num_rebinds == 3 && a.num_debinds == 0);
+
+  // leaving a tracker tells it, and rebinding to the same tracker does nothing
+  rs[0].rptr.rebind (b);
+  rs[0].rptr.rebind (b);
+  assert (a.num_debinds == 1 && b.num_rebinds == 1);
+
+  // the tracker tells each reporter it drops
+  a.debind (rs[1].rptr);
+  assert (rs[1].num_debinds == 1 && rs[2].num_debinds == 0);
+
+  b.erase (b.begin ());
+  assert (rs[0].num_debinds == 1 && ! rs[0].rptr.has_remote ());
+
+  for (hooked_reporter<Storage>& r : rs)
+    r.rptr.rebind (a);
+  a.clear ();
+  assert (rs[0].num_debinds == 2 && rs[1].num_debinds == 2 && rs[2].num_debinds == 1);
+
+  // as do move assignment and destruction
+  rs[0].rptr.rebind (a);
+  a = std::move (b);
+  assert (rs[0].num_debinds == 3);
+
+  {
+    hooked_tracker<Storage> c;
+    for (hooked_reporter<Storage>& r : rs)
+      r.rptr.rebind (c);
+  }
+  assert (rs[0].num_debinds == 4 && rs[1].num_debinds == 3 && rs[2].num_debinds == 2);
+
+  // the reporters dropping themselves do not call their own hooks
+  rs[0].rptr.rebind (a);
+  rs[0].rptr.debind ();
+  assert (rs[0].num_debinds == 4);
+}
+
+static
+void
+test_debind_hooks (void)
+{
+  std::cout << "test debind hooks" << std::endl;
+
+  test_debind_hooks<storage::list> ();
+  test_debind_hooks<storage::hashed<>> ();
+  test_debind_hooks<storage::sorted<>> ();
+  test_debind_hooks<storage::compact<>> ();
+
+  std::cout << "end" << std::endl;
+}
+
+template <typename Tracker>
+static
+void
+assert_num_allocations (std::size_t, std::false_type)
+{ }
+
+template <typename Tracker>
+static
+void
+assert_num_allocations (std::size_t n, std::true_type)
+{
+  assert (get_tracker_stats<Tracker> ().num_allocations == n);
+}
+
+template <typename Storage>
+static
+void
+test_linked_storage (void)
+{
+  using tracker_type  = tracker<int, remote::standalone_reporter, tag::nonintrusive, Storage>;
+  using reporter_type = standalone_reporter<remote::tracker<int, Storage>>;
+
+  reset_tracker_stats ();
+
+  int v = 0;
+  int w = 1;
+  tracker_type tkr (v);
+
+  std::vector<reporter_type> rs (4);
+  for (reporter_type& r : rs)
+    r.rebind (tkr);
+
+  auto check_positions = [&rs](const tracker_type& t, int& parent)
+  {
+    std::size_t pos = 0;
+    for (auto it = t.begin (); it != t.end (); ++it, ++pos)
+    {
+      assert (&it.get_remote_interface () == &rs[pos]);
+      assert (rs[pos].get_position () == pos);
+      assert (&rs[pos].get_remote () == &parent);
+    }
+    assert (pos == t.num_remotes ());
+  };
+
+  check_positions (tkr, v);
+
+  // growing the vector relocates the reporters, and their nodes along with them
+  rs.reserve (2 * rs.capacity ());
+  check_positions (tkr, v);
+
+  // moving and splicing the tracker only relink the nodes
+  tracker_type moved (std::move (tkr), w);
+  assert (tkr.empty ());
+  check_positions (moved, w);
+
+  tkr.splice_back (moved);
+  check_positions (tkr, v);
+
+  // rebinding takes the node out of one tracker and into the other
+  tracker_type other (w);
+  rs[1].rebind (other);
+  rs[1].rebind (other);
+  assert (tkr.num_remotes () == 3 && other.num_remotes () == 1);
+  assert (&other.front () == &rs[1] && &rs[1].get_remote () == &w);
+
+  // as does binding from the side of the tracker, even at the position of the reporter
+  other.insert (other.begin (), std::move (rs[2]));
+  other.insert (other.begin (), std::move (rs[2]));
+  assert (tkr.num_remotes () == 2 && other.num_remotes () == 2);
+  assert (&other.front () == &rs[2] && &other.back () == &rs[1]);
+
+  // swapping reporters of different trackers swaps their nodes
+  rs[0].swap (rs[1]);
+  assert (&rs[0].get_remote () == &w && &rs[1].get_remote () == &v);
+  assert (&other.back () == &rs[0] && &tkr.front () == &rs[1]);
+
+  reporter_type r4 (std::move (rs[3]));
+  assert (! rs[3].has_remote () && &tkr.back () == &r4);
+
+  other.replace (other.begin (), r4);
+  assert (! rs[2].has_remote () && &other.front () == &r4 && tkr.num_remotes () == 1);
+
+  other.transfer_back (tkr, tkr.begin ());
+  assert (tkr.empty () && other.num_remotes () == 3);
+  assert (&other.back () == &rs[1] && &rs[1].get_remote () == &w);
+  assert (rs[1].get_position () == 2);
+
+  rs[0].debind ();
+  assert (other.num_remotes () == 2 && &other.front () == &r4);
+
+  other.clear ();
+  assert (! r4.has_remote () && ! rs[1].has_remote ());
+
+  // none of the above allocated
+  assert_num_allocations<tracker_type> (0, typename Storage::is_instrumented { });
+}
+
+static
+void
+test_linked_storage (void)
+{
+  std::cout << "test linked storage" << std::endl;
+
+  test_linked_storage<storage::linked> ();
+  test_linked_storage<storage::instrumented<storage::linked>> ();
+  test_linked_storage<storage::concurrent<storage::linked>> ();
+
+  std::cout << "end" << std::endl;
+}
+
+template <typename Storage>
+static
+void
+test_paired_storage (void)
+{
+  using node_type = multireporter<int, int, Storage>;
+
+  reset_tracker_stats ();
+  const std::size_t in_use = get_pool_stats ().num_in_use;
+  auto num_edges = [in_use](void) { return get_pool_stats ().num_in_use - in_use; };
+
+  std::array<int, 4> values { };
+  std::vector<node_type> nodes (values.begin (), values.end ());
+  nodes.reserve (2 * nodes.size ());
+
+  // both ends of each binding come from one allocation
+  for (std::size_t i = 0; i < nodes.size (); ++i)
+    for (std::size_t j = i + 1; j < nodes.size (); ++j)
+      nodes[i].bind (nodes[j]);
+  assert (num_edges () == 6);
+  assert (nodes[0].num_remotes () == 3 && nodes[3].num_remotes () == 3);
+  assert_num_allocations<node_type> (6, typename Storage::is_instrumented { });
+
+  // which is freed once, from either end
+  nodes[0].debind (nodes[1]);
+  assert (num_edges () == 5);
+  nodes[2].debind (nodes[0]);
+  assert (num_edges () == 4);
+  assert (nodes[0].num_remotes () == 1 && nodes[1].num_remotes () == 2);
+
+  // replacing a binding frees the old one and makes a new one in its place
+  nodes[1].replace (nodes[1].begin (), nodes[0]);
+  assert (num_edges () == 4);
+  assert (&nodes[1].front () == &values[0] && nodes[0].num_remotes () == 2);
+  assert (nodes[2].num_remotes () == 1);
+
+  // moving and splicing trackers do not touch the allocations
+  int w = 4;
+  node_type moved (std::move (nodes[3]), w);
+  assert (num_edges () == 4 && moved.num_remotes () == 3);
+  assert (&nodes[1].back () == &w && &nodes[2].back () == &w);
+
+  int x = 5;
+  node_type spliced (x);
+  spliced.splice_back (moved);
+  assert (num_edges () == 4 && spliced.num_remotes () == 3 && moved.empty ());
+  assert (&nodes[2].back () == &x);
+
+  spliced.clear ();
+  assert (num_edges () == 1 && nodes[1].num_remotes () == 1);
+
+  // bindings between trackers which are destroyed together are freed by the second of them
+  destroy_all (nodes.begin (), nodes.begin () + 3);
+  assert (num_edges () == 0);
+}
+
+static
+void
+test_paired_storage (void)
+{
+  std::cout << "test paired storage" << std::endl;
+
+  test_paired_storage<storage::paired<>> ();
+  test_paired_storage<storage::instrumented<storage::paired<>>> ();
+  test_paired_storage<storage::concurrent<storage::paired<>>> ();
+
+  std::cout << "end" << std::endl;
+}
+
+template <typename Storage>
+static
+void
+test_edge_data (void)
+{
+  using tracker_type  = tracker<int, remote::standalone_reporter, tag::nonintrusive, Storage>;
+  using reporter_type = standalone_reporter<remote::tracker<int, Storage>>;
+
+  int v = 0;
+  int w = 1;
+  tracker_type tkr (v);
+  tracker_type other (w);
+
+  std::vector<reporter_type> rs (3);
+  for (reporter_type& r : rs)
+    r.rebind (tkr);
+
+  // each binding starts out with value-initialized data, which both ends can reach
+  double weight = 0.5;
+  for (auto it = tkr.begin (); it != tkr.end (); ++it)
+  {
+    assert (it.get_edge () == 0.0);
+    it.get_edge () = weight;
+    weight *= 2;
+  }
+  assert (rs[0].get_edge () == 0.5 && rs[1].get_edge () == 1.0 && rs[2].get_edge () == 2.0);
+
+  rs[1].get_edge () = 3.0;
+  const tracker_type& ctkr = tkr;
+  assert (std::next (ctkr.begin ()).get_edge () == 3.0);
+
+  // the data follows the binding when either end moves
+  reporter_type r3 (std::move (rs[2]));
+  assert (r3.get_edge () == 2.0);
+
+  auto pos = tkr.begin ();
+  while (&pos.get_remote_interface () != &rs[0])
+    ++pos;
+  other.transfer_back (tkr, pos);
+  assert (&rs[0].get_remote () == &w && rs[0].get_edge () == 0.5);
+  assert (rs[1].get_edge () == 3.0);
+
+  tracker_type moved (std::move (tkr), v);
+  assert (rs[1].get_edge () == 3.0 && r3.get_edge () == 2.0);
+
+  // but a new binding starts over
+  r3.rebind (other);
+  assert (r3.get_edge () == 0.0 && rs[0].get_edge () == 0.5);
+}
+
+template <typename Storage>
+static
+void
+test_tracker_edge_data (void)
+{
+  using node_type = multireporter<int, int, Storage>;
+
+  int a = 0;
+  int b = 1;
+  node_type na (a);
+  node_type nb (b);
+  na.bind (nb);
+
+  // each end of a binding between trackers keeps its own data
+  na.begin ().get_edge () = 1;
+  nb.begin ().get_edge () = 2;
+  assert (na.begin ().get_edge () == 1 && nb.begin ().get_edge () == 2);
+
+  node_type moved (std::move (na), a);
+  assert (moved.begin ().get_edge () == 1 && nb.begin ().get_edge () == 2);
+}
+
+static
+void
+test_edge_data (void)
+{
+  std::cout << "test edge data" << std::endl;
+
+  test_edge_data<storage::with_edge_data<double>> ();
+  test_edge_data<storage::with_edge_data<double, storage::small<2>>> ();
+  test_edge_data<storage::with_edge_data<double, storage::compact<>>> ();
+  test_edge_data<storage::with_edge_data<double, storage::linked>> ();
+  test_edge_data<storage::hashed<storage::with_edge_data<double>>> ();
+  test_edge_data<storage::instrumented<storage::with_edge_data<double, storage::sorted<>>>> ();
+
+  test_tracker_edge_data<storage::with_edge_data<int>> ();
+  test_tracker_edge_data<storage::with_edge_data<int, storage::paired<>>> ();
+
+  std::cout << "end" << std::endl;
+}
+
+struct thread_executor
+{
+  template <typename Task>
+  void
+  operator() (Task task)
+  {
+    threads.emplace_back (task);
+  }
+
+  std::vector<std::thread>& threads;
+};
+
+struct inline_executor
+{
+  template <typename Task>
+  void
+  operator() (Task task) const
+  {
+    task ();
+  }
+};
+
+struct throwing_executor
+{
+  template <typename Task>
+  void
+  operator() (Task) const
+  {
+    throw std::runtime_error ("executor");
+  }
+};
+
+template <typename Storage>
+static
+void
+test_parallel_for_each_remote (void)
+{
+  using tracker_type  = tracker<int, remote::standalone_reporter, tag::nonintrusive, Storage>;
+  using reporter_type = standalone_reporter<remote::tracker<int, Storage>>;
+
+  constexpr std::size_t n = 1000;
+  constexpr std::size_t num_debound = 10;
+
+  int v = 0;
+  tracker_type tkr (v);
+
+  std::vector<reporter_type> rs (n);
+  for (reporter_type& r : rs)
+    r.rebind (tkr);
+
+  // left dead in the list with tombstoned storage
+  for (std::size_t i = 0; i < num_debound; ++i)
+    rs[i].debind ();
+
+  std::atomic<std::size_t> sum (0);
+  std::atomic<std::size_t> count (0);
+  auto visit = [&](reporter_type& r)
+  {
+    sum.fetch_add (static_cast<std::size_t> (&r - rs.data ()), std::memory_order_relaxed);
+    count.fetch_add (1, std::memory_order_relaxed);
+  };
+
+  const std::size_t expected = n * (n - 1) / 2 - num_debound * (num_debound - 1) / 2;
+
+  std::vector<std::thread> threads;
+  tkr.parallel_for_each_remote (visit, thread_executor { threads }, 4);
+  for (std::thread& t : threads)
+    t.join ();
+  assert (threads.size () == 3);
+  assert (count == n - num_debound && sum == expected);
+
+  // every run is visited once, whichever thread runs it
+  sum = 0;
+  count = 0;
+  tkr.parallel_for_each_remote (visit, inline_executor { }, 16);
+  assert (count == n - num_debound && sum == expected);
+
+  // if the executor can't take a task, the calling thread visits everything
+  sum = 0;
+  count = 0;
+  tkr.parallel_for_each_remote (visit, throwing_executor { }, 4);
+  assert (count == n - num_debound && sum == expected);
+
+  // exceptions thrown by `f` come out of the call
+  bool thrown = false;
+  try
+  {
+    tkr.parallel_for_each_remote ([](reporter_type&) { throw std::runtime_error ("f"); },
+                                  inline_executor { }, 4);
+  }
+  catch (const std::runtime_error&)
+  {
+    thrown = true;
+  }
+  assert (thrown);
+}
+
+static
+void
+test_parallel_for_each_remote (void)
+{
+  std::cout << "test parallel for_each_remote" << std::endl;
+
+  test_parallel_for_each_remote<storage::list> ();
+  test_parallel_for_each_remote<storage::small<2>> ();
+  test_parallel_for_each_remote<storage::compact<>> ();
+  test_parallel_for_each_remote<storage::indexed<>> ();
+  test_parallel_for_each_remote<storage::concurrent<storage::tombstoned<>>> ();
+
+  std::cout << "end" << std::endl;
+}
+
+template <typename Storage>
+static
+std::size_t
+test_segments (void)
+{
+  using tracker_type  = tracker<int, remote::standalone_reporter, tag::nonintrusive, Storage>;
+  using reporter_type = standalone_reporter<remote::tracker<int, Storage>>;
+
+  int v = 0;
+  tracker_type tkr (v);
+
+  std::vector<reporter_type> rs (100);
+  for (reporter_type& r : rs)
+    r.rebind (tkr);
+
+  // leave some holes
+  for (std::size_t i = 0; i < rs.size (); i += 7)
+    rs[i].debind ();
+
+  std::vector<const reporter_type *> visited;
+  std::size_t num_segments = 0;
+  tkr.for_each_segment ([&](const typename tracker_type::segment_type& seg)
+                        {
+                          assert (seg.size () != 0);
+                          assert (static_cast<std::size_t> (
+                                    std::distance (seg.begin (), seg.end ())) == seg.size ());
+
+                          std::size_t i = 0;
+                          std::for_each (seg.begin (), seg.end (), [&](reporter_type& r)
+                                         {
+                                           assert (&r == &seg[i++]);
+                                           visited.push_back (&r);
+                                         });
+                          ++num_segments;
+                        });
+
+  // the segments cover the remotes in order
+  assert (visited.size () == tkr.num_remotes ());
+  std::size_t pos = 0;
+  for (const reporter_type& r : tkr)
+    assert (&r == visited[pos++]);
+
+  return num_segments;
+}
+
+static
+void
+test_segments (void)
+{
+  std::cout << "test segments" << std::endl;
+
+  test_segments<storage::list> ();
+  test_segments<storage::small<2>> ();
+  test_segments<storage::indexed<>> ();
+  test_segments<storage::concurrent<storage::tombstoned<>>> ();
+
+  // the slots of compact storage are allocated in order, so the holes split them
+  assert (test_segments<storage::compact<>> () == 15);
+
+  std::cout << "end" << std::endl;
+}
+
+template <typename Tracker>
+static
+void
+assert_num_remote_writes (std::size_t, std::false_type)
+{ }
+
+template <typename Tracker>
+static
+void
+assert_num_remote_writes (std::size_t n, std::true_type)
+{
+  assert (get_tracker_stats<Tracker> ().num_remote_writes == n);
+}
+
+template <typename Storage>
+static
+void
+test_destroy_all (void)
+{
+  using node_type = multireporter<int, int, Storage>;
+
+  std::array<int, 10> values { };
+  std::vector<std::unique_ptr<node_type>> nodes;
+  for (int& v : values)
+    nodes.emplace_back (new node_type (v));
+
+  // a complete graph on the first 8, with a few bindings out to the last 2
+  for (std::size_t i = 0; i < 8; ++i)
+    for (std::size_t j = i + 1; j < 8; ++j)
+      nodes[i]->bind (*nodes[j]);
+  nodes[0]->bind (*nodes[8]);
+  nodes[3]->bind (*nodes[8]);
+  nodes[5]->bind (*nodes[9]);
+  nodes[8]->bind (*nodes[9]);
+  assert (nodes[8]->num_remotes () == 3);
+
+  reset_tracker_stats ();
+  destroy_all (nodes.begin (), nodes.begin () + 8,
+               [](std::unique_ptr<node_type>& p) -> node_type& { return *p; });
+
+  // only the bindings out of the range were written to
+  assert_num_remote_writes<node_type> (3, typename Storage::is_instrumented { });
+  assert (std::all_of (nodes.begin (), nodes.begin () + 8,
+                       [](const std::unique_ptr<node_type>& p) { return p->empty (); }));
+  assert (nodes[8]->num_remotes () == 1 && &nodes[8]->front () == &values[9]);
+  assert (nodes[9]->num_remotes () == 1 && &nodes[9]->front () == &values[8]);
+
+  nodes.erase (nodes.begin (), nodes.begin () + 8);
+  assert (nodes[0]->num_remotes () == 1);
+
+  // nodes bound only to each other, and an empty range
+  destroy_all (nodes.begin (), nodes.end (),
+               [](std::unique_ptr<node_type>& p) -> node_type& { return *p; });
+  destroy_all (nodes.begin (), nodes.end (),
+               [](std::unique_ptr<node_type>& p) -> node_type& { return *p; });
+  assert (nodes[0]->empty () && nodes[1]->empty ());
+
+  std::vector<std::reference_wrapper<node_type>> none;
+  destroy_all (none.begin (), none.end (),
+               [](std::reference_wrapper<node_type> r) -> node_type& { return r; });
+}
+
+static
+void
+test_destroy_all (void)
+{
+  std::cout << "test destroy_all" << std::endl;
+
+  test_destroy_all<storage::list> ();
+  test_destroy_all<storage::small<2>> ();
+  test_destroy_all<storage::hashed<>> ();
+  test_destroy_all<storage::sorted<>> ();
+  test_destroy_all<storage::compact<>> ();
+  test_destroy_all<storage::instrumented<>> ();
+
+  std::cout << "end" << std::endl;
+}
+
+static
+void
+test_range (void)
+{
+  std::cout << "test range construction" << std::endl;
+
+  std::vector<int> data { 3, 5, 7, 5, 5, 8, 2, 7 };
+  std::vector<tracker<int, remote::standalone_tracker>> r;
+  std::transform (data.begin (), data.end (), std::back_inserter (r),
+                  [](int& x) { return tracker<int, remote::standalone_tracker> { x }; });
+
+  std::vector<std::reference_wrapper<tracker<int, remote::standalone_tracker>>> filtered;
+  std::copy_if (r.begin (), r.end (), std::back_inserter (filtered),
+                [](tracker<int, remote::standalone_tracker>& t) { return t.get_parent () == 5; });
+
+  standalone_tracker<remote::tracker<int>> tkr { tag::bind, filtered.begin (), filtered.end () };
+  auto print_tkr = [&tkr](void)
+  {
+    std::cout << "{" << std::endl;
+    std::for_each (tkr.begin (), tkr.end (), [](int& i) { std::cout << "  " << i << std::endl; });
+    std::cout << "}" << std::endl;
+  };
+
+  print_tkr ();
+  // std::vector<tracker<int, remote::standalone_tracker> *> filtered1;
+  // std::for_each (r.begin (), r.end (), [&filtered1](tracker<int, remote::standalone_tracker>& t)
+  //                                      {
+  //                                        if (t.get_parent () == 3)
+  //                                          filtered1.emplace_back (&t);
+  //                                      });
+  // standalone_tracker<remote::tracker<int>> tkr1 { tag::bind, filtered1.begin (), filtered1.end () };
+  filtered.clear ();
+  std::copy_if (r.begin (), r.end (), std::back_inserter (filtered),
+                [](tracker<int, remote::standalone_tracker>& t) { return t.get_parent () == 3; });
+
+  tkr.bind (filtered.begin (), filtered.end ());
+
+  print_tkr ();
+
+  filtered.clear ();
+  std::copy_if (r.begin (), r.end (), std::back_inserter (filtered),
+                [](tracker<int, remote::standalone_tracker>& t) { return t.get_parent () == 7; });
+
+  tkr.insert (std::next (tkr.begin ()), filtered.begin (), filtered.end ());
+
+  print_tkr ();
+  std::cout << "end" << std::endl;
+}
+
+static
+void
+test_iterators (void)
+{
+  std::cout << "test iterators" << std::endl;
+
+  std::vector<int> data { 3, 5, 7, 5, 5, 8, 2, 7 };
+  std::vector<tracker<int, remote::standalone_tracker>> r;
+  std::transform (data.begin (), data.end (), std::back_inserter (r),
+                  [](int& x) { return tracker<int, remote::standalone_tracker> { x }; });
+
+  std::vector<std::reference_wrapper<tracker<int, remote::standalone_tracker>>> filtered;
+  std::copy_if (r.begin (), r.end (), std::back_inserter (filtered),
+                [](tracker<int, remote::standalone_tracker>& t) { return t.get_parent () == 5; });
+
+  standalone_tracker<remote::tracker<int>> tkr { tag::bind, filtered.begin (), filtered.end () };
+
+  standalone_tracker<remote::tracker<int>>::iter it = tkr.begin ();
+  standalone_tracker<remote::tracker<int>>::citer cit = it;
+  (void)cit;
+
+  std::cout << "end" << std::endl;
+}
+
+class B;
+
+class A
+  : public intrusive_reporter<A, remote::intrusive_tracker<B>>
+{
+  using base = intrusive_reporter<A, remote::intrusive_tracker<B>>;
+
+  public:
+    using reporter_type       = base;
+    using remote_tracker_type = typename tracker_traits<reporter_type>::remote_interface_type;
+    using remote_iterator     = remote_tracker_type::citer;
+};
+
+class B
+  : public intrusive_tracker<B, remote::intrusive_reporter<A>>
+{ };
+
+int
+main()
+{
+  try
+  {
+    standalone_tracker<remote::intrusive::reporter<mix>> mix_tkr;
+    standalone_reporter<remote::intrusive_tracker<mix>> mix_rptr;
+
+    mix mx (mix_tkr, mix_rptr);
+    if (mx.has_remote ())
+    {
+      mix& rem = mix_rptr.get_remote ();
+      std::cout << rem.num_remotes () << std::endl;
+    }
+
+    test_debinding ();
+
+    iparent ip ("ip");
+    ichild ic1 (ip.create ("ic1"));
+    ichild ic2 (ip.create ("ic2"));
+
+    std::cout << test_reporter<child, parent> ().count () << std::endl;
+    std::cout << test_reporter<nonintruded_child_s, nonintruded_parent_s> ().count () << std::endl;
+
+
+    plf::list<int> x = {1, 2, 3, 4};
+    plf::list<int>::iterator last = --x.end ();
+    std::reverse_iterator<plf::list<int>::iterator> rb (x.end ());
+    std::cout << (*last == *rb) << std::endl;
+
+    test_multireporter ();
+
+//      std::cout << "got back" << std::endl;
 
     test_disparate_multireporter ();
     test_binding ();
@@ -1877,6 +3494,29 @@ main()
     tracker<parent, remote::reporter<int>, tag::intrusive> xp;
 
     test_range ();
+    test_splicing ();
+    test_relocation ();
+    test_storage ();
+    test_small_storage ();
+    test_indexed_storage ();
+    test_hashed_storage ();
+    test_concurrent_storage ();
+    test_tombstoned_storage ();
+    test_concurrent_iteration ();
+    test_allocators ();
+    test_pooled_storage ();
+    test_compact_storage ();
+    test_bulk_bind ();
+    test_capacity ();
+    test_sorted_storage ();
+    test_instrumented_storage ();
+    test_debind_hooks ();
+    test_destroy_all ();
+    test_linked_storage ();
+    test_paired_storage ();
+    test_edge_data ();
+    test_parallel_for_each_remote ();
+    test_segments ();
   }
   catch (std::exception &e)
   {
@@ -1903,6 +3543,8 @@ main()
   std::cout << "nreporter : ntracker  :" << sizeof (          reporter<child, remote::tracker <parent>>          ) << std::endl << std::endl;
 
   std::cout << "iter  :" << sizeof (tracker<child, remote::reporter<parent>>::iter) << std::endl;
+  std::cout << "compact nreporter : ntracker :"
+            << sizeof (reporter<child, remote::tracker<parent, storage::compact<>>>) << std::endl;
 
   return 0;
 }